@@ -1,4 +1,5 @@
 #include "CollisionExporter.h"
+#include "Globals.h"
 
 void ExporterExample_Collision::Save(ZResource* res, [[maybe_unused]] const fs::path& outPath,
                                      BinaryWriter* writer)
@@ -34,34 +35,33 @@ void ExporterExample_Collision::Save(ZResource* res, [[maybe_unused]] const fs::
 
 	writer->Seek(col->vtxSegmentOffset, SeekOffsetType::Start);
 
-	for (uint16_t i = 0; i < col->vertices.size(); i++)
+	for (size_t i = 0; i < col->vertices.size(); i++)
 	{
-		for (uint32_t j = 0; j < col->vertices[i].dimensions; j++)
-		{
-			writer->Write(col->vertices[i].scalars[j].scalarData.s16);
-		}
+		writer->Write(col->vertices.x[i]);
+		writer->Write(col->vertices.y[i]);
+		writer->Write(col->vertices.z[i]);
 	}
 
 	writer->Seek(col->polySegmentOffset, SeekOffsetType::Start);
 
-	for (uint16_t i = 0; i < col->polygons.size(); i++)
+	for (size_t i = 0; i < col->polygons.size(); i++)
 	{
-		writer->Write(col->polygons[i].type);
-		writer->Write(col->polygons[i].vtxA);
-		writer->Write(col->polygons[i].vtxB);
-		writer->Write(col->polygons[i].vtxC);
-		writer->Write(col->polygons[i].normX);
-		writer->Write(col->polygons[i].normY);
-		writer->Write(col->polygons[i].normZ);
-		writer->Write(col->polygons[i].dist);
+		writer->Write(col->polygons.type[i]);
+		writer->Write(col->polygons.vtxA[i]);
+		writer->Write(col->polygons.vtxB[i]);
+		writer->Write(col->polygons.vtxC[i]);
+		writer->Write(col->polygons.normX[i]);
+		writer->Write(col->polygons.normY[i]);
+		writer->Write(col->polygons.normZ[i]);
+		writer->Write(col->polygons.dist[i]);
 	}
 
 	writer->Seek(col->polyTypeDefSegmentOffset, SeekOffsetType::Start);
 
-	for (const auto& poly : col->polygonTypes)
+	for (size_t i = 0; i < col->polygonTypes.size(); i++)
 	{
-		writer->Write(poly.data[0]);
-		writer->Write(poly.data[1]);
+		writer->Write(col->polygonTypes.data0[i]);
+		writer->Write(col->polygonTypes.data1[i]);
 	}
 	writer->Seek(col->camDataSegmentOffset, SeekOffsetType::Start);
 
@@ -72,5 +72,28 @@ void ExporterExample_Collision::Save(ZResource* res, [[maybe_unused]] const fs::
 		writer->Write(entry.cameraPosDataSeg);
 	}
 
+	if (Globals::Instance->buildCollisionBVH)
+	{
+		// The tree goes after everything else, so the other offsets keep their meaning
+		writer->Seek(0, SeekOffsetType::End);
+
+		writer->Write((uint32_t)col->bvh.nodes.size());
+		for (const CollisionBVHNode& node : col->bvh.nodes)
+		{
+			writer->Write(node.minX);
+			writer->Write(node.minY);
+			writer->Write(node.minZ);
+			writer->Write(node.maxX);
+			writer->Write(node.maxY);
+			writer->Write(node.maxZ);
+			writer->Write(node.index);
+			writer->Write(node.count);
+		}
+
+		writer->Write((uint32_t)col->bvh.polyIndices.size());
+		for (uint16_t index : col->bvh.polyIndices)
+			writer->Write(index);
+	}
+
 	writer->Seek(oldOffset, SeekOffsetType::Start);
 }
@@ -0,0 +1,60 @@
+#include "DisplayListExporter.h"
+#include "Globals.h"
+
+void ExporterExample_DisplayList::Save(ZResource* res, [[maybe_unused]] const fs::path& outPath,
+                                       BinaryWriter* writer)
+{
+	ZDisplayList* dList = (ZDisplayList*)res;
+	DListBinary binary = dList->LowerToBinary();
+
+	writer->Write((uint32_t)binary.resourcePaths.size());
+	for (const std::string& path : binary.resourcePaths)
+		writer->Write(path);
+
+	// Resolved commands hold an index into the path table in place of their address
+	writer->Write((uint32_t)binary.references.size());
+	for (const DListBinaryReference& ref : binary.references)
+	{
+		writer->Write((uint32_t)ref.commandIndex);
+		writer->Write(ref.offset);
+	}
+
+	writer->Write((uint32_t)binary.commands.size());
+	for (uint64_t command : binary.commands)
+		writer->Write(command);
+
+	if (!Globals::Instance->exportMeshBatches)
+		return;
+
+	// The batches go after the display list, a count of 0 means it can only be replayed
+	std::vector<DListMeshBatch> batches;
+	if (!dList->BuildMeshBatches(batches))
+		batches.clear();
+
+	writer->Write((uint32_t)batches.size());
+	for (const DListMeshBatch& batch : batches)
+	{
+		writer->Write((uint32_t)batch.state.size());
+		for (uint64_t command : batch.state)
+			writer->Write(command);
+
+		writer->Write((uint32_t)batch.vertices.size());
+		for (const VtxData& vtx : batch.vertices)
+		{
+			writer->Write(vtx.x);
+			writer->Write(vtx.y);
+			writer->Write(vtx.z);
+			writer->Write(vtx.flag);
+			writer->Write(vtx.s);
+			writer->Write(vtx.t);
+			writer->Write(vtx.r);
+			writer->Write(vtx.g);
+			writer->Write(vtx.b);
+			writer->Write(vtx.a);
+		}
+
+		writer->Write((uint32_t)batch.indices.size());
+		for (uint16_t index : batch.indices)
+			writer->Write(index);
+	}
+}
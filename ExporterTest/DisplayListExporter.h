@@ -0,0 +1,10 @@
+#pragma once
+
+#include "ZDisplayList.h"
+#include "ZResource.h"
+
+class ExporterExample_DisplayList : public ZResourceExporter
+{
+public:
+	void Save(ZResource* res, const fs::path& outPath, BinaryWriter* writer) override;
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "CollisionExporter.h"
+#include "DisplayListExporter.h"
 #include "Globals.h"
 #include "RoomExporter.h"
 #include "TextureExporter.h"
@@ -70,6 +71,7 @@ static void ImportExporters()
 	exporterSet->exporters[ZResourceType::Texture] = new ExporterExample_Texture();
 	exporterSet->exporters[ZResourceType::Room] = new ExporterExample_Room();
 	exporterSet->exporters[ZResourceType::CollisionHeader] = new ExporterExample_Collision();
+	exporterSet->exporters[ZResourceType::DisplayList] = new ExporterExample_DisplayList();
 
 	Globals::AddExporter("EXAMPLE", exporterSet);
 }
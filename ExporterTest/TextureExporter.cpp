@@ -6,7 +6,23 @@ void ExporterExample_Texture::Save(ZResource* res, [[maybe_unused]] const fs::pa
 {
 	ZTexture* tex = (ZTexture*)res;
 
-	auto data = tex->parent->GetRawData();
+	// An identical texture has been exported already, only write where to find it
+	if (tex->IsExportedByOwner())
+	{
+		writer->Write(tex->GetOwnerResourcePath());
+		return;
+	}
+
+	if (tex->IsExportedAsRGBA8())
+	{
+		std::vector<uint8_t> rgba = tex->GetRGBA8Data();
+
+		for (uint8_t value : rgba)
+			writer->Write(value);
+		return;
+	}
+
+	const auto& data = tex->parent->GetRawData();
 
 	for (offset_t i = tex->GetRawDataIndex(); i < tex->GetRawDataIndex() + tex->GetRawDataSize();
 	     i++)
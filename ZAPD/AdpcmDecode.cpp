@@ -0,0 +1,234 @@
+#include "AdpcmDecode.h"
+
+#include <stdexcept>
+
+#include "BulkDecode.h"
+#include "Utils/StringHelper.h"
+#include "ZAudio.h"
+
+#if defined(__SSE4_1__) || defined(__AVX__)
+#include <smmintrin.h>
+#define ADPCM_DECODE_SSE41 1
+#define ADPCM_DECODE_SSE2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ADPCM_DECODE_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ADPCM_DECODE_NEON 1
+#endif
+
+// SampleEntry::codec values
+static constexpr uint8_t CODEC_ADPCM = 0;
+static constexpr uint8_t CODEC_S8 = 1;
+static constexpr uint8_t CODEC_S16_INMEMORY = 2;
+static constexpr uint8_t CODEC_SMALL_ADPCM = 3;
+static constexpr uint8_t CODEC_S16 = 5;
+
+#if defined(ADPCM_DECODE_SSE2)
+static inline __m128i MulLo32(__m128i a, __m128i b)
+{
+#if defined(ADPCM_DECODE_SSE41)
+	return _mm_mullo_epi32(a, b);
+#else
+	// The low 32 bits of a product don't depend on the signedness of its operands
+	__m128i even = _mm_mul_epu32(a, b);
+	__m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+	return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+	                          _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+#endif
+}
+#endif
+
+/**
+ * Computes 8 outputs as `matrix * in`, divided by 2048 rounding down and saturated to 16 bits.
+ * `matrix` is column-major with `columns` columns of 8 rows. Sums are 32 bits wide, which the
+ * game's books and scales stay well within.
+ */
+static void MatrixProduct(const int32_t* matrix, int32_t columns, const int32_t* in, int16_t* dst)
+{
+#if defined(ADPCM_DECODE_SSE2)
+	__m128i lo = _mm_setzero_si128();
+	__m128i hi = _mm_setzero_si128();
+
+	for (int32_t k = 0; k < columns; k++)
+	{
+		const __m128i value = _mm_set1_epi32(in[k]);
+		const int32_t* column = matrix + k * 8;
+
+		lo = _mm_add_epi32(
+			lo, MulLo32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(column)), value));
+		hi = _mm_add_epi32(
+			hi, MulLo32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(column + 4)), value));
+	}
+
+	__m128i result = _mm_packs_epi32(_mm_srai_epi32(lo, 11), _mm_srai_epi32(hi, 11));
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(dst), result);
+#elif defined(ADPCM_DECODE_NEON)
+	int32x4_t lo = vdupq_n_s32(0);
+	int32x4_t hi = vdupq_n_s32(0);
+
+	for (int32_t k = 0; k < columns; k++)
+	{
+		const int32_t* column = matrix + k * 8;
+
+		lo = vmlaq_n_s32(lo, vld1q_s32(column), in[k]);
+		hi = vmlaq_n_s32(hi, vld1q_s32(column + 4), in[k]);
+	}
+
+	vst1q_s16(dst, vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, 11)), vqmovn_s32(vshrq_n_s32(hi, 11))));
+#else
+	for (int32_t i = 0; i < 8; i++)
+	{
+		uint32_t sum = 0;
+
+		for (int32_t k = 0; k < columns; k++)
+			sum += static_cast<uint32_t>(matrix[k * 8 + i]) * static_cast<uint32_t>(in[k]);
+
+		int32_t value = static_cast<int32_t>(sum) >> 11;
+		dst[i] = static_cast<int16_t>(value < -0x8000 ? -0x8000 : (value > 0x7FFF ? 0x7FFF : value));
+	}
+#endif
+}
+
+std::vector<int32_t> AdpcmDecode::ExpandBook(const AdpcmBook& book)
+{
+	const int32_t order = book.order;
+	const int32_t columns = order + 8;
+
+	if (order <= 0 || book.npredictors <= 0 ||
+	    book.books.size() < static_cast<size_t>(8 * order * book.npredictors))
+	{
+		throw std::runtime_error(
+			StringHelper::Sprintf("AdpcmDecode::ExpandBook: invalid book (order %i, %i predictors, "
+		                          "%zu coefficients)",
+		                          order, book.npredictors, book.books.size()));
+	}
+
+	std::vector<int32_t> coefs(static_cast<size_t>(book.npredictors) * columns * 8, 0);
+
+	for (int32_t p = 0; p < book.npredictors; p++)
+	{
+		const int16_t* src = book.books.data() + p * order * 8;
+		int32_t* matrix = coefs.data() + p * columns * 8;
+
+		// The book is already stored as `order` columns of 8 rows
+		for (int32_t i = 0; i < order * 8; i++)
+			matrix[i] = src[i];
+
+		// Column `order` applies the first residual to every row. Each row feeds the next one,
+		// so it is 2048 (1.0) followed by the book's last column, moved down one row
+		int32_t* first = matrix + order * 8;
+		first[0] = 1 << 11;
+		for (int32_t i = 1; i < 8; i++)
+			first[i] = matrix[(order - 1) * 8 + i - 1];
+
+		// Later residuals only reach the rows from their own onwards
+		for (int32_t k = 1; k < 8; k++)
+		{
+			int32_t* column = first + k * 8;
+
+			for (int32_t i = k; i < 8; i++)
+				column[i] = first[i - k];
+		}
+	}
+
+	return coefs;
+}
+
+void AdpcmDecode::DecodeFrames(const uint8_t* src, size_t frameCount, size_t frameSize,
+                               const std::vector<int32_t>& coefs, int32_t order,
+                               int32_t npredictors, int16_t* history, int16_t* dst)
+{
+	const int32_t columns = order + 8;
+	std::vector<int32_t> in(columns);
+
+	for (size_t f = 0; f < frameCount; f++)
+	{
+		const uint8_t* frame = src + f * frameSize;
+		const int32_t scale = 1 << (frame[0] >> 4);
+		const int32_t predictor = frame[0] & 0x0F;
+
+		if (predictor >= npredictors)
+		{
+			throw std::runtime_error(StringHelper::Sprintf(
+				"AdpcmDecode::DecodeFrames: frame %zu uses predictor %i, but the book only has %i",
+				f, predictor, npredictors));
+		}
+
+		// Sign-extend the residuals
+		int32_t residuals[16];
+		if (frameSize == 5)
+		{
+			for (int32_t i = 0; i < 16; i++)
+				residuals[i] = static_cast<int8_t>(frame[1 + i / 4] << (2 * (i % 4))) >> 6;
+		}
+		else
+		{
+			for (int32_t i = 0; i < 16; i++)
+				residuals[i] = static_cast<int8_t>(frame[1 + i / 2] << (4 * (i % 2))) >> 4;
+		}
+
+		const int32_t* matrix = coefs.data() + predictor * columns * 8;
+		int16_t* out = dst + f * 16;
+
+		for (int32_t half = 0; half < 2; half++)
+		{
+			for (int32_t i = 0; i < order; i++)
+				in[i] = history[i];
+			for (int32_t i = 0; i < 8; i++)
+				in[order + i] = residuals[half * 8 + i] * scale;
+
+			MatrixProduct(matrix, columns, in.data(), out + half * 8);
+
+			// Keep the last `order` outputs, oldest first
+			for (int32_t i = 0; i < order; i++)
+				history[i] = (i + 8 < order) ? history[i + 8] : out[half * 8 + i + 8 - order];
+		}
+	}
+}
+
+std::vector<int16_t> AdpcmDecode::DecodeSample(const SampleEntry& sample)
+{
+	std::vector<int16_t> pcm;
+
+	switch (sample.codec)
+	{
+	case CODEC_ADPCM:
+	case CODEC_SMALL_ADPCM:
+	{
+		const size_t frameSize = sample.codec == CODEC_SMALL_ADPCM ? 5 : 9;
+		const size_t frameCount = sample.data.size() / frameSize;
+		const std::vector<int32_t> coefs = ExpandBook(sample.book);
+		std::vector<int16_t> history(sample.book.order, 0);
+
+		pcm.resize(frameCount * 16);
+		DecodeFrames(sample.data.data(), frameCount, frameSize, coefs, sample.book.order,
+		             sample.book.npredictors, history.data(), pcm.data());
+	}
+	break;
+
+	case CODEC_S8:
+		pcm.resize(sample.data.size());
+		for (size_t i = 0; i < pcm.size(); i++)
+			pcm[i] = static_cast<int16_t>(static_cast<int8_t>(sample.data[i]) * 256);
+		break;
+
+	case CODEC_S16_INMEMORY:
+	case CODEC_S16:
+		pcm.resize(sample.data.size() / 2);
+		BulkDecode::SwapS16(sample.data.data(), pcm.data(), pcm.size());
+		break;
+
+	default:
+		throw std::runtime_error(StringHelper::Sprintf(
+			"AdpcmDecode::DecodeSample: %s uses unsupported codec %i", sample.fileName.c_str(),
+			sample.codec));
+	}
+
+	// The loop end is the length of the sample, the last frame may be padding
+	if (sample.loop.end != 0 && sample.loop.end < pcm.size())
+		pcm.resize(sample.loop.end);
+
+	return pcm;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct AdpcmBook;
+struct SampleEntry;
+
+/**
+ * In-memory decoder from the N64 VADPCM sample codecs to 16-bit PCM.
+ * Each frame holds a header byte and 16 residuals, 4 bits each (9-byte frames) or 2 bits each
+ * (5-byte frames). Every half frame is the product of a predictor's coefficient matrix and the
+ * previous outputs plus residuals, computed 8 lanes at a time with SSE2/NEON when available and
+ * with a scalar fallback. Outputs are saturated to 16 bits before they become the next history,
+ * like the RSP does.
+ */
+class AdpcmDecode
+{
+public:
+	/**
+	 * Expands `book` into one column-major matrix per predictor: `order + 8` columns of 8 rows,
+	 * the book's own columns followed by the ones applying the residuals.
+	 */
+	static std::vector<int32_t> ExpandBook(const AdpcmBook& book);
+
+	/**
+	 * Decodes `frameCount` frames of `frameSize` bytes into 16 samples each. `history` holds the
+	 * last `order` outputs, oldest first, and is updated for the next call.
+	 */
+	static void DecodeFrames(const uint8_t* src, size_t frameCount, size_t frameSize,
+	                         const std::vector<int32_t>& coefs, int32_t order,
+	                         int32_t npredictors, int16_t* history, int16_t* dst);
+
+	// Decodes the whole sample, whatever its codec, up to the end of its loop
+	static std::vector<int16_t> DecodeSample(const SampleEntry& sample);
+};
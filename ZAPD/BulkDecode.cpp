@@ -0,0 +1,329 @@
+#include "BulkDecode.h"
+
+#include <cstring>
+#include <stdexcept>
+
+#include "Utils/StringHelper.h"
+
+// Big-endian hosts (i.e. the PowerPC of CafeOS) already hold the values in their source order
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__) || defined(__BIG_ENDIAN__)
+#define BULK_DECODE_BIG_ENDIAN 1
+#endif
+
+// The vector kernels swap bytes, so they are only used on little-endian hosts
+#if defined(BULK_DECODE_BIG_ENDIAN)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BULK_DECODE_SSE2 1
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define BULK_DECODE_NEON 1
+#endif
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#define BULK_BSWAP16(x) _byteswap_ushort(x)
+#define BULK_BSWAP32(x) _byteswap_ulong(x)
+#else
+#define BULK_BSWAP16(x) __builtin_bswap16(x)
+#define BULK_BSWAP32(x) __builtin_bswap32(x)
+#endif
+
+static inline uint16_t LoadU16BE(const uint8_t* src)
+{
+	uint16_t value;
+	memcpy(&value, src, sizeof(value));
+#if defined(BULK_DECODE_BIG_ENDIAN)
+	return value;
+#else
+	return BULK_BSWAP16(value);
+#endif
+}
+
+static inline uint32_t LoadU32BE(const uint8_t* src)
+{
+	uint32_t value;
+	memcpy(&value, src, sizeof(value));
+#if defined(BULK_DECODE_BIG_ENDIAN)
+	return value;
+#else
+	return BULK_BSWAP32(value);
+#endif
+}
+
+// Converts `count` big-endian 16-bit values to host order, `dst` may alias `src`
+static void SwapBytes16(const uint8_t* src, uint8_t* dst, size_t count)
+{
+#if defined(BULK_DECODE_BIG_ENDIAN)
+	if (count != 0)
+		memmove(dst, src, count * 2);
+	return;
+#endif
+
+	size_t i = 0;
+
+#if defined(BULK_DECODE_SSE2)
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 2), v);
+	}
+#elif defined(BULK_DECODE_NEON)
+	for (; i + 8 <= count; i += 8)
+		vst1q_u8(dst + i * 2, vrev16q_u8(vld1q_u8(src + i * 2)));
+#endif
+
+	for (; i < count; i++)
+	{
+		uint16_t value = LoadU16BE(src + i * 2);
+		memcpy(dst + i * 2, &value, sizeof(value));
+	}
+}
+
+// Converts `count` big-endian 32-bit values to host order, `dst` may alias `src`
+static void SwapBytes32(const uint8_t* src, uint8_t* dst, size_t count)
+{
+#if defined(BULK_DECODE_BIG_ENDIAN)
+	if (count != 0)
+		memmove(dst, src, count * 4);
+	return;
+#endif
+
+	size_t i = 0;
+
+#if defined(BULK_DECODE_SSE2)
+	for (; i + 4 <= count; i += 4)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+		// Swap the bytes of each 16-bit half, then swap the halves
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+		v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), v);
+	}
+#elif defined(BULK_DECODE_NEON)
+	for (; i + 4 <= count; i += 4)
+		vst1q_u8(dst + i * 4, vrev32q_u8(vld1q_u8(src + i * 4)));
+#endif
+
+	for (; i < count; i++)
+	{
+		uint32_t value = LoadU32BE(src + i * 4);
+		memcpy(dst + i * 4, &value, sizeof(value));
+	}
+}
+
+void BulkDecode::SwapU16(const uint8_t* src, uint16_t* dst, size_t count)
+{
+	SwapBytes16(src, reinterpret_cast<uint8_t*>(dst), count);
+}
+
+void BulkDecode::SwapS16(const uint8_t* src, int16_t* dst, size_t count)
+{
+	SwapBytes16(src, reinterpret_cast<uint8_t*>(dst), count);
+}
+
+void BulkDecode::SwapU32(const uint8_t* src, uint32_t* dst, size_t count)
+{
+	SwapBytes32(src, reinterpret_cast<uint8_t*>(dst), count);
+}
+
+void BulkDecode::SwapS32(const uint8_t* src, int32_t* dst, size_t count)
+{
+	SwapBytes32(src, reinterpret_cast<uint8_t*>(dst), count);
+}
+
+void BulkDecode::SwapFloat(const uint8_t* src, float* dst, size_t count)
+{
+	static_assert(sizeof(float) == sizeof(uint32_t), "float must be 32 bits wide");
+	SwapBytes32(src, reinterpret_cast<uint8_t*>(dst), count);
+}
+
+void BulkDecode::ExtractU16Strided(const uint8_t* src, size_t stride, uint16_t* dst, size_t count)
+{
+	if (stride == 2)
+	{
+		SwapU16(src, dst, count);
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++, src += stride)
+		dst[i] = LoadU16BE(src);
+}
+
+void BulkDecode::ExtractS16Strided(const uint8_t* src, size_t stride, int16_t* dst, size_t count)
+{
+	ExtractU16Strided(src, stride, reinterpret_cast<uint16_t*>(dst), count);
+}
+
+void BulkDecode::ExtractU32Strided(const uint8_t* src, size_t stride, uint32_t* dst, size_t count)
+{
+	if (stride == 4)
+	{
+		SwapU32(src, dst, count);
+		return;
+	}
+
+	for (size_t i = 0; i < count; i++, src += stride)
+		dst[i] = LoadU32BE(src);
+}
+
+void BulkDecode::DeinterleaveU16x8(const uint8_t* src, uint16_t* const dst[8], size_t count)
+{
+	size_t i = 0;
+
+#if defined(BULK_DECODE_SSE2)
+	// Transposes 8 records at a time as an 8x8 matrix of 16-bit values
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i r[8];
+		for (size_t n = 0; n < 8; n++)
+		{
+			r[n] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + (i + n) * 16));
+			r[n] = _mm_or_si128(_mm_slli_epi16(r[n], 8), _mm_srli_epi16(r[n], 8));
+		}
+
+		// Fields 0-3 and 4-7 of two records each
+		__m128i t0 = _mm_unpacklo_epi16(r[0], r[1]);
+		__m128i t1 = _mm_unpackhi_epi16(r[0], r[1]);
+		__m128i t2 = _mm_unpacklo_epi16(r[2], r[3]);
+		__m128i t3 = _mm_unpackhi_epi16(r[2], r[3]);
+		__m128i t4 = _mm_unpacklo_epi16(r[4], r[5]);
+		__m128i t5 = _mm_unpackhi_epi16(r[4], r[5]);
+		__m128i t6 = _mm_unpacklo_epi16(r[6], r[7]);
+		__m128i t7 = _mm_unpackhi_epi16(r[6], r[7]);
+
+		// Two fields of four records each
+		__m128i u0 = _mm_unpacklo_epi32(t0, t2);
+		__m128i u1 = _mm_unpackhi_epi32(t0, t2);
+		__m128i u2 = _mm_unpacklo_epi32(t1, t3);
+		__m128i u3 = _mm_unpackhi_epi32(t1, t3);
+		__m128i u4 = _mm_unpacklo_epi32(t4, t6);
+		__m128i u5 = _mm_unpackhi_epi32(t4, t6);
+		__m128i u6 = _mm_unpacklo_epi32(t5, t7);
+		__m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+		const __m128i fields[8] = {
+			_mm_unpacklo_epi64(u0, u4), _mm_unpackhi_epi64(u0, u4), _mm_unpacklo_epi64(u1, u5),
+			_mm_unpackhi_epi64(u1, u5), _mm_unpacklo_epi64(u2, u6), _mm_unpackhi_epi64(u2, u6),
+			_mm_unpacklo_epi64(u3, u7), _mm_unpackhi_epi64(u3, u7),
+		};
+
+		for (size_t n = 0; n < 8; n++)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst[n] + i), fields[n]);
+	}
+#elif defined(BULK_DECODE_NEON)
+	for (; i + 8 <= count; i += 8)
+	{
+		// Each register holds fields `n` and `n + 4` of four records, alternating
+		uint16x8x4_t first = vld4q_u16(reinterpret_cast<const uint16_t*>(src + i * 16));
+		uint16x8x4_t second = vld4q_u16(reinterpret_cast<const uint16_t*>(src + i * 16 + 64));
+
+		for (size_t n = 0; n < 4; n++)
+		{
+			uint16x8x2_t fields = vuzpq_u16(first.val[n], second.val[n]);
+			vst1q_u16(dst[n] + i,
+			          vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(fields.val[0]))));
+			vst1q_u16(dst[n + 4] + i,
+			          vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(fields.val[1]))));
+		}
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		for (size_t n = 0; n < 8; n++)
+			dst[n][i] = LoadU16BE(src + i * 16 + n * 2);
+	}
+}
+
+void BulkDecode::SwapU16Fields(const uint8_t* src, uint8_t* dst, size_t recordCount,
+                               size_t recordSize, uint32_t fieldMask)
+{
+	size_t i = 0;
+
+#if defined(BULK_DECODE_BIG_ENDIAN)
+	if (recordCount != 0)
+		memmove(dst, src, recordCount * recordSize);
+	return;
+#endif
+
+#if defined(BULK_DECODE_SSE2) || defined(BULK_DECODE_NEON)
+	// 16-byte records (i.e. Vtx) fit exactly in one vector register
+	if (recordSize == 16)
+	{
+		alignas(16) uint16_t laneMask[8];
+		for (size_t lane = 0; lane < 8; lane++)
+			laneMask[lane] = (fieldMask & (1 << lane)) ? 0xFFFF : 0x0000;
+
+#if defined(BULK_DECODE_SSE2)
+		const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(laneMask));
+		for (; i < recordCount; i++)
+		{
+			__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 16));
+			__m128i swapped = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+			v = _mm_or_si128(_mm_and_si128(mask, swapped), _mm_andnot_si128(mask, v));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 16), v);
+		}
+#else
+		const uint8x16_t mask = vreinterpretq_u8_u16(vld1q_u16(laneMask));
+		for (; i < recordCount; i++)
+		{
+			uint8x16_t v = vld1q_u8(src + i * 16);
+			vst1q_u8(dst + i * 16, vbslq_u8(mask, vrev16q_u8(v), v));
+		}
+#endif
+		return;
+	}
+#endif
+
+	for (; i < recordCount; i++)
+	{
+		const uint8_t* srcRecord = src + i * recordSize;
+		uint8_t* dstRecord = dst + i * recordSize;
+
+		memmove(dstRecord, srcRecord, recordSize);
+		for (size_t field = 0; field * 2 + 1 < recordSize; field++)
+		{
+			if (fieldMask & (1 << field))
+			{
+				uint8_t hi = srcRecord[field * 2];
+				uint8_t lo = srcRecord[field * 2 + 1];
+				dstRecord[field * 2] = lo;
+				dstRecord[field * 2 + 1] = hi;
+			}
+		}
+	}
+}
+
+void BulkDecode::CheckBounds(const std::vector<uint8_t>& data, size_t offset, size_t size,
+                             const char* caller)
+{
+	if (offset > data.size() || size > data.size() - offset)
+	{
+		throw std::runtime_error(StringHelper::Sprintf(
+			"%s: reading 0x%zX bytes at offset 0x%06zX is out of bounds (data size 0x%06zX)",
+			caller, size, offset, data.size()));
+	}
+}
+
+std::vector<int16_t> BulkDecode::ReadS16Array(const std::vector<uint8_t>& data, size_t offset,
+                                              size_t count)
+{
+	CheckBounds(data, offset, count * 2, "BulkDecode::ReadS16Array");
+
+	std::vector<int16_t> values(count);
+	SwapS16(data.data() + offset, values.data(), count);
+	return values;
+}
+
+std::vector<uint16_t> BulkDecode::ReadU16Array(const std::vector<uint8_t>& data, size_t offset,
+                                               size_t count)
+{
+	CheckBounds(data, offset, count * 2, "BulkDecode::ReadU16Array");
+
+	std::vector<uint16_t> values(count);
+	SwapU16(data.data() + offset, values.data(), count);
+	return values;
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Bulk big-endian decode kernels.
+ * These are the array counterparts of BitConverter, meant for parsers that read long runs of
+ * values. Values are converted to host order: little-endian hosts swap them, using SSE2/NEON when
+ * available, and big-endian hosts only copy them.
+ */
+class BulkDecode
+{
+public:
+	// Converts `count` consecutive big-endian values from `src` to host order into `dst`
+	static void SwapU16(const uint8_t* src, uint16_t* dst, size_t count);
+	static void SwapS16(const uint8_t* src, int16_t* dst, size_t count);
+	static void SwapU32(const uint8_t* src, uint32_t* dst, size_t count);
+	static void SwapS32(const uint8_t* src, int32_t* dst, size_t count);
+	static void SwapFloat(const uint8_t* src, float* dst, size_t count);
+
+	// Reads the big-endian field at `src + i * stride` for every element `i`
+	static void ExtractU16Strided(const uint8_t* src, size_t stride, uint16_t* dst, size_t count);
+	static void ExtractS16Strided(const uint8_t* src, size_t stride, int16_t* dst, size_t count);
+	static void ExtractU32Strided(const uint8_t* src, size_t stride, uint32_t* dst, size_t count);
+
+	/**
+	 * Splits `count` records of 8 big-endian 16-bit fields (i.e. CollisionPoly) into one array
+	 * per field, `dst[n]` receiving field `n` of every record.
+	 */
+	static void DeinterleaveU16x8(const uint8_t* src, uint16_t* const dst[8], size_t count);
+
+	/**
+	 * Copies `recordCount` records of `recordSize` bytes, converting the big-endian 16-bit fields
+	 * selected by `fieldMask` (bit `n` selects the field at byte `2 * n`) to host order. Other bytes
+	 * are copied as-is.
+	 */
+	static void SwapU16Fields(const uint8_t* src, uint8_t* dst, size_t recordCount,
+	                          size_t recordSize, uint32_t fieldMask);
+
+	// Throws if `size` bytes starting at `offset` don't fit in `data`
+	static void CheckBounds(const std::vector<uint8_t>& data, size_t offset, size_t size,
+	                        const char* caller);
+
+	static std::vector<int16_t> ReadS16Array(const std::vector<uint8_t>& data, size_t offset,
+	                                         size_t count);
+	static std::vector<uint16_t> ReadU16Array(const std::vector<uint8_t>& data, size_t offset,
+	                                          size_t count);
+};
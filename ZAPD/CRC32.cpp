@@ -0,0 +1,96 @@
+#include "CRC32.h"
+
+#include <cstddef>
+
+/*
+ * Slicing-by-8 version of the original bit-by-bit loop:
+ *
+ *     crc ^= byte;
+ *     for (j = 0; j < 8; j++)
+ *         crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));  // with a signed, arithmetic shift
+ *
+ * The update is still linear, so it can be split into per-byte tables. The only difference from
+ * the usual slicing is that the sign bit of the running CRC never shifts out, which is folded
+ * back in with `signFix`.
+ */
+
+struct CRC32Tables
+{
+	uint32_t slice[8][256];  // slice[k][b]: byte `b` followed by `k` zero bytes
+	uint32_t signFix;
+};
+
+static constexpr uint32_t CRC32Step(uint32_t crc)
+{
+	// Arithmetic shift right, spelled out on an unsigned value
+	return (crc >> 1) ^ (crc & 0x80000000) ^ (0xEDB88320 & (0 - (crc & 1)));
+}
+
+static constexpr uint32_t CRC32Byte(uint32_t crc, uint8_t byte)
+{
+	crc ^= byte;
+	for (int32_t j = 0; j < 8; j++)
+		crc = CRC32Step(crc);
+	return crc;
+}
+
+static constexpr CRC32Tables MakeCRC32Tables()
+{
+	CRC32Tables tables = {};
+
+	for (uint32_t b = 0; b < 256; b++)
+	{
+		uint32_t crc = CRC32Byte(0, b);
+
+		tables.slice[0][b] = crc;
+		for (size_t k = 1; k < 8; k++)
+		{
+			crc = CRC32Byte(crc, 0);
+			tables.slice[k][b] = crc;
+		}
+	}
+
+	// Running 8 zero bytes from a state with only the sign bit set, compared to feeding that bit
+	// in as data
+	uint32_t fromState = 0x80000000;
+	for (size_t k = 0; k < 8; k++)
+		fromState = CRC32Byte(fromState, 0);
+	tables.signFix = fromState ^ tables.slice[4][0x80];
+
+	return tables;
+}
+
+static constexpr CRC32Tables crc32Tables = MakeCRC32Tables();
+
+static inline uint32_t LoadU32LE(const unsigned char* src)
+{
+	return src[0] | (src[1] << 8) | (src[2] << 16) | (static_cast<uint32_t>(src[3]) << 24);
+}
+
+uint32_t CRC32B(const unsigned char* message, int32_t size)
+{
+	const auto& slice = crc32Tables.slice;
+	uint32_t crc = 0xFFFFFFFF;
+	size_t count = size > 0 ? size : 0;
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8)
+	{
+		uint32_t signMask = 0 - (crc >> 31);
+		uint32_t lo = crc ^ LoadU32LE(message + i);
+		uint32_t hi = LoadU32LE(message + i + 4);
+
+		crc = slice[7][lo & 0xFF] ^ slice[6][(lo >> 8) & 0xFF] ^ slice[5][(lo >> 16) & 0xFF] ^
+		      slice[4][lo >> 24] ^ slice[3][hi & 0xFF] ^ slice[2][(hi >> 8) & 0xFF] ^
+		      slice[1][(hi >> 16) & 0xFF] ^ slice[0][hi >> 24];
+		crc ^= crc32Tables.signFix & signMask;
+	}
+
+	for (; i < count; i++)
+	{
+		uint32_t signMask = 0 - (crc >> 31);
+		crc = slice[0][(crc ^ message[i]) & 0xFF] ^ (crc >> 8) ^ (signMask & 0xFF000000);
+	}
+
+	return ~crc;
+}
@@ -1,23 +1,10 @@
 #pragma once
 
-static uint32_t CRC32B(const unsigned char* message, int32_t size)
-{
-	int32_t byte, crc;
-	int32_t mask;
-
-	crc = 0xFFFFFFFF;
-
-	for (int32_t i = 0; i < size; i++)
-	{
-		byte = message[i];
-		crc = crc ^ byte;
-
-		for (int32_t j = 7; j >= 0; j--)
-		{
-			mask = -(crc & 1);
-			crc = (crc >> 1) ^ (0xEDB88320 & mask);
-		}
-	}
-
-	return ~(uint32_t)(crc);
-}
\ No newline at end of file
+#include <cstdint>
+
+/**
+ * The CRC32 used for texture hashes (e.g. the texture pool).
+ * Note that this is not the standard CRC-32: the original bit-by-bit implementation shifted a
+ * signed value, so the top bit is sticky. The hashes in existing texture pools depend on it.
+ */
+uint32_t CRC32B(const unsigned char* message, int32_t size);
@@ -0,0 +1,135 @@
+#include "CollisionBVH.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+#include "Utils/StringHelper.h"
+#include "ZCollision.h"
+
+struct CollisionPolyBounds
+{
+	int16_t min[3];
+	int16_t max[3];
+	int32_t center[3];  // Twice the center, so it stays an integer
+};
+
+static void BuildNode(CollisionBVH& bvh, const std::vector<CollisionPolyBounds>& bounds,
+                      size_t first, size_t count, size_t depth)
+{
+	const size_t nodeIndex = bvh.nodes.size();
+	bvh.nodes.emplace_back();
+	bvh.depth = std::max(bvh.depth, depth);
+
+	int16_t nodeMin[3] = {INT16_MAX, INT16_MAX, INT16_MAX};
+	int16_t nodeMax[3] = {INT16_MIN, INT16_MIN, INT16_MIN};
+	int32_t centerMin[3] = {INT32_MAX, INT32_MAX, INT32_MAX};
+	int32_t centerMax[3] = {INT32_MIN, INT32_MIN, INT32_MIN};
+
+	for (size_t i = first; i < first + count; i++)
+	{
+		const CollisionPolyBounds& poly = bounds[bvh.polyIndices[i]];
+
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			nodeMin[axis] = std::min(nodeMin[axis], poly.min[axis]);
+			nodeMax[axis] = std::max(nodeMax[axis], poly.max[axis]);
+			centerMin[axis] = std::min(centerMin[axis], poly.center[axis]);
+			centerMax[axis] = std::max(centerMax[axis], poly.center[axis]);
+		}
+	}
+
+	CollisionBVHNode& node = bvh.nodes[nodeIndex];
+	node.minX = nodeMin[0];
+	node.minY = nodeMin[1];
+	node.minZ = nodeMin[2];
+	node.maxX = nodeMax[0];
+	node.maxY = nodeMax[1];
+	node.maxZ = nodeMax[2];
+
+	if (count <= CollisionBVH::maxLeafPolys)
+	{
+		node.index = static_cast<uint16_t>(first);
+		node.count = static_cast<uint16_t>(count);
+		bvh.leafCount++;
+		return;
+	}
+
+	size_t axis = 0;
+	for (size_t i = 1; i < 3; i++)
+	{
+		if (centerMax[i] - centerMin[i] > centerMax[axis] - centerMin[axis])
+			axis = i;
+	}
+
+	// Ties are broken by index, so the split doesn't depend on the sort implementation
+	const size_t half = count / 2;
+	auto begin = bvh.polyIndices.begin() + first;
+	auto byCenter = [&bounds, axis](uint16_t a, uint16_t b) {
+		return std::tie(bounds[a].center[axis], a) < std::tie(bounds[b].center[axis], b);
+	};
+	std::nth_element(begin, begin + half, begin + count, byCenter);
+
+	// `node` may be invalidated by the children being added
+	bvh.nodes[nodeIndex].count = 0;
+	BuildNode(bvh, bounds, first, half, depth + 1);
+	bvh.nodes[nodeIndex].index = static_cast<uint16_t>(bvh.nodes.size());
+	BuildNode(bvh, bounds, first + half, count - half, depth + 1);
+}
+
+void CollisionBVH::Build(const CollisionVertexList& vertices, const CollisionPolyList& polygons)
+{
+	nodes.clear();
+	polyIndices.clear();
+	leafCount = 0;
+	depth = 0;
+
+	const size_t polyCount = polygons.size();
+	if (polyCount == 0)
+		return;
+
+	std::vector<CollisionPolyBounds> bounds(polyCount);
+
+	for (size_t i = 0; i < polyCount; i++)
+	{
+		// The top bits of the first two indices are flags
+		const size_t indices[3] = {polygons.vtxA[i] & 0x1FFFu, polygons.vtxB[i] & 0x1FFFu,
+		                           polygons.vtxC[i]};
+		CollisionPolyBounds& poly = bounds[i];
+
+		for (size_t axis = 0; axis < 3; axis++)
+		{
+			poly.min[axis] = INT16_MAX;
+			poly.max[axis] = INT16_MIN;
+		}
+
+		for (size_t index : indices)
+		{
+			if (index >= vertices.size())
+			{
+				throw std::runtime_error(StringHelper::Sprintf(
+					"CollisionBVH::Build: polygon %zu uses vertex %zu, but there are only %zu", i,
+					index, vertices.size()));
+			}
+
+			const int16_t position[3] = {vertices.x[index], vertices.y[index], vertices.z[index]};
+			for (size_t axis = 0; axis < 3; axis++)
+			{
+				poly.min[axis] = std::min(poly.min[axis], position[axis]);
+				poly.max[axis] = std::max(poly.max[axis], position[axis]);
+			}
+		}
+
+		for (size_t axis = 0; axis < 3; axis++)
+			poly.center[axis] = poly.min[axis] + poly.max[axis];
+	}
+
+	polyIndices.resize(polyCount);
+	for (size_t i = 0; i < polyCount; i++)
+		polyIndices[i] = static_cast<uint16_t>(i);
+
+	// Only nodes with more than 4 polygons are split, so leaves hold at least 2 of them. There
+	// are fewer nodes than polygons and 16-bit indices are enough
+	nodes.reserve(polyCount);
+	BuildNode(*this, bounds, 0, polyCount, 1);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class CollisionVertexList;
+class CollisionPolyList;
+
+/**
+ * A 16-byte node of a CollisionBVH, bounding its polygons in collision space
+ */
+struct CollisionBVHNode
+{
+	int16_t minX, minY, minZ;
+	int16_t maxX, maxY, maxZ;
+	uint16_t index;  // Leaves: first entry in `polyIndices`. Inner nodes: the second child
+	uint16_t count;  // Number of polygons in a leaf, 0 for inner nodes
+};
+
+/**
+ * Bounding volume hierarchy over the polygons of a collision header, so raycasts and floor
+ * checks don't have to test every polygon.
+ * The nodes are stored depth-first, so the first child of an inner node is the node after it.
+ * Each split is at the median polygon along the longest axis of the polygons' centers, which
+ * keeps the tree balanced and the build deterministic.
+ */
+class CollisionBVH
+{
+public:
+	static constexpr size_t maxLeafPolys = 4;
+
+	std::vector<CollisionBVHNode> nodes;
+	std::vector<uint16_t> polyIndices;
+	size_t leafCount = 0;
+	size_t depth = 0;
+
+	void Build(const CollisionVertexList& vertices, const CollisionPolyList& polygons);
+};
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <map>
+#include <set>
 #include <string>
 #include <vector>
 #include "GameConfig.h"
+#include "ImageBackend.h"
 #include "ZFile.h"
 #include "ZRom.h"
 #include "FileWorker.h"
@@ -41,6 +43,14 @@ public:
 	bool forceStatic = false;
 	bool forceUnaccountedStatic = false;
 	bool otrMode = true;
+	bool binaryOnly = false;  // Skips the C source text the exporters don't read
+	PngEncodeSettings pngSettings;
+	size_t pngEncodeThreads = 0;  // Background PNG encoders, started once the mode is known
+	std::set<TextureType> rgba8TextureFormats;  // Exported pre-decoded to RGBA8
+	bool exportMeshBatches = false;  // Display lists are also exported as indexed triangle batches
+	bool exportAudioPCM = false;  // Audio samples are also decoded to 16-bit PCM
+	bool dedupAudioSamples = false;  // Audio samples with identical contents are exported once
+	bool buildCollisionBVH = false;  // Collision headers are also exported with a BVH
 	bool buildRawTexture = false;
 	bool onlyGenSohOtr = false;
 
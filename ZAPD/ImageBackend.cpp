@@ -1,6 +1,9 @@
 #include "ImageBackend.h"
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cinttypes>
 #include <cstdlib>
 #include <png.h>
 #include <stdexcept>
@@ -8,6 +11,39 @@
 #include "Utils/StringHelper.h"
 #include "WarningHandler.h"
 
+static_assert(sizeof(png_color) == 3, "colorPalette is stored as packed png_color entries");
+
+static constexpr size_t pngCompressionCount = static_cast<size_t>(PngCompression::Max) + 1;
+static const char* pngCompressionNames[pngCompressionCount] = {"fast", "default", "max"};
+
+static std::atomic<uint64_t> pngEncodeCount[pngCompressionCount];
+static std::atomic<uint64_t> pngEncodeBytes[pngCompressionCount];
+static std::atomic<uint64_t> pngEncodeNs[pngCompressionCount];
+
+static int GetPngFilterMask(const PngEncodeSettings& settings)
+{
+	switch (settings.filter)
+	{
+	case PngFilter::None:
+		return PNG_FILTER_NONE;
+	case PngFilter::Sub:
+		return PNG_FILTER_SUB;
+	case PngFilter::Up:
+		return PNG_FILTER_UP;
+	case PngFilter::Average:
+		return PNG_FILTER_AVG;
+	case PngFilter::Paeth:
+		return PNG_FILTER_PAETH;
+	case PngFilter::All:
+		return PNG_ALL_FILTERS;
+	case PngFilter::Auto:
+		break;
+	}
+
+	// Filtering barely pays off at the fast level, and 0 keeps libpng's default otherwise
+	return settings.compression == PngCompression::Fast ? PNG_FILTER_NONE : 0;
+}
+
 /* ImageBackend */
 
 ImageBackend::~ImageBackend()
@@ -110,13 +146,10 @@ void ImageBackend::ReadPng(const char* filename)
 	png_read_update_info(png, info);
 
 	size_t rowBytes = png_get_rowbytes(png, info);
-	pixelMatrix = (uint8_t**)malloc(sizeof(uint8_t*) * height);
-	for (size_t y = 0; y < height; y++)
-	{
-		pixelMatrix[y] = (uint8_t*)malloc(rowBytes);
-	}
+	AllocImageData(rowBytes);
 
-	png_read_image(png, pixelMatrix);
+	std::vector<uint8_t*> rowPointers = GetRowPointers();
+	png_read_image(png, rowPointers.data());
 
 #ifdef TEXTURE_DEBUG
 	printf("rowBytes: %zu\n", rowBytes);
@@ -129,7 +162,7 @@ void ImageBackend::ReadPng(const char* filename)
 		{
 			for (size_t z = 0; z < bytePerPixel; z++)
 			{
-				printf("%02X ", pixelMatrix[y][x * bytePerPixel + z]);
+				printf("%02X ", pixelData[y * stride + x * bytePerPixel + z]);
 			}
 			printf(" ");
 		}
@@ -141,8 +174,6 @@ void ImageBackend::ReadPng(const char* filename)
 	fclose(fp);
 
 	png_destroy_read_struct(&png, &info, nullptr);
-
-	hasImageData = true;
 }
 
 void ImageBackend::ReadPng(const fs::path& filename)
@@ -150,10 +181,12 @@ void ImageBackend::ReadPng(const fs::path& filename)
 	ReadPng(filename.string().c_str());
 }
 
-void ImageBackend::WritePng(const char* filename)
+void ImageBackend::WritePng(const char* filename, const PngEncodeSettings& settings) const
 {
 	assert(hasImageData);
 
+	auto start = std::chrono::steady_clock::now();
+
 	FILE* fp = fopen(filename, "wb");
 	if (fp == nullptr)
 	{
@@ -182,6 +215,15 @@ void ImageBackend::WritePng(const char* filename)
 
 	png_init_io(png, fp);
 
+	if (settings.compression == PngCompression::Fast)
+		png_set_compression_level(png, 1);
+	else if (settings.compression == PngCompression::Max)
+		png_set_compression_level(png, 9);
+
+	int filterMask = GetPngFilterMask(settings);
+	if (filterMask != 0)
+		png_set_filter(png, PNG_FILTER_TYPE_BASE, filterMask);
+
 	png_set_IHDR(png, info, width, height,
 	             bitDepth,   // 8,
 	             colorType,  // PNG_COLOR_TYPE_RGBA,
@@ -189,11 +231,12 @@ void ImageBackend::WritePng(const char* filename)
 
 	if (isColorIndexed)
 	{
-		png_set_PLTE(png, info, static_cast<png_color*>(colorPalette), paletteSize);
+		png_set_PLTE(png, info, reinterpret_cast<const png_color*>(colorPalette.data()),
+		             paletteSize);
 
 #ifdef TEXTURE_DEBUG
 		printf("palette\n");
-		png_color* aux = (png_color*)colorPalette;
+		const png_color* aux = reinterpret_cast<const png_color*>(colorPalette.data());
 		for (size_t y = 0; y < paletteSize; y++)
 		{
 			printf("#%02X%02X%02X ", aux[y].red, aux[y].green, aux[y].blue);
@@ -203,7 +246,7 @@ void ImageBackend::WritePng(const char* filename)
 		printf("\n");
 #endif
 
-		png_set_tRNS(png, info, alphaPalette, paletteSize, nullptr);
+		png_set_tRNS(png, info, alphaPalette.data(), paletteSize, nullptr);
 	}
 
 	png_write_info(png, info);
@@ -219,26 +262,53 @@ void ImageBackend::WritePng(const char* filename)
 	{
 		for (size_t x = 0; x < width * bytePerPixel; x++)
 		{
-			printf("%02X ", pixelMatrix[y][x]);
+			printf("%02X ", pixelData[y * stride + x]);
 		}
 		printf("\n");
 	}
 	printf("\n");
 #endif
 
-	png_write_image(png, pixelMatrix);
+	std::vector<uint8_t*> rowPointers = GetRowPointers();
+	png_write_image(png, rowPointers.data());
 	png_write_end(png, nullptr);
 
+	long fileSize = ftell(fp);
 	fclose(fp);
 
 	png_destroy_write_struct(&png, &info);
+
+	auto end = std::chrono::steady_clock::now();
+	size_t level = static_cast<size_t>(settings.compression);
+	pngEncodeCount[level].fetch_add(1, std::memory_order_relaxed);
+	pngEncodeBytes[level].fetch_add(fileSize > 0 ? fileSize : 0, std::memory_order_relaxed);
+	pngEncodeNs[level].fetch_add(
+		std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+		std::memory_order_relaxed);
 }
 
-void ImageBackend::WritePng(const fs::path& filename)
+void ImageBackend::WritePng(const fs::path& filename, const PngEncodeSettings& settings) const
 {
 	// Note: The .string() is necessary for MSVC, due to the implementation of std::filesystem
 	// differing from GCC. Do not remove!
-	WritePng(filename.string().c_str());
+	WritePng(filename.string().c_str(), settings);
+}
+
+void ImageBackend::PrintPngEncodeReport()
+{
+	for (size_t level = 0; level < pngCompressionCount; level++)
+	{
+		uint64_t count = pngEncodeCount[level].load(std::memory_order_relaxed);
+
+		if (count == 0)
+			continue;
+
+		uint64_t bytes = pngEncodeBytes[level].load(std::memory_order_relaxed);
+		uint64_t ms = pngEncodeNs[level].load(std::memory_order_relaxed) / 1000000;
+
+		printf("PNG encoding (%s): %" PRIu64 " files, %" PRIu64 " KB, %" PRIu64 " ms\n",
+		       pngCompressionNames[level], count, bytes / 1024, ms);
+	}
 }
 
 void ImageBackend::SetTextureData(const std::vector<std::vector<RGBAPixel>>& texData,
@@ -254,21 +324,21 @@ void ImageBackend::SetTextureData(const std::vector<std::vector<RGBAPixel>>& tex
 
 	size_t bytePerPixel = GetBytesPerPixel();
 
-	pixelMatrix = static_cast<uint8_t**>(malloc(sizeof(uint8_t*) * height));
+	AllocImageData(width * bytePerPixel);
 	for (size_t y = 0; y < height; y++)
 	{
-		pixelMatrix[y] = static_cast<uint8_t*>(malloc(sizeof(uint8_t*) * width * bytePerPixel));
+		uint8_t* row = GetRowData(y);
+
 		for (size_t x = 0; x < width; x++)
 		{
-			pixelMatrix[y][x * bytePerPixel + 0] = texData.at(y).at(x).r;
-			pixelMatrix[y][x * bytePerPixel + 1] = texData.at(y).at(x).g;
-			pixelMatrix[y][x * bytePerPixel + 2] = texData.at(y).at(x).b;
+			row[x * bytePerPixel + 0] = texData.at(y).at(x).r;
+			row[x * bytePerPixel + 1] = texData.at(y).at(x).g;
+			row[x * bytePerPixel + 2] = texData.at(y).at(x).b;
 
 			if (colorType == PNG_COLOR_TYPE_RGBA)
-				pixelMatrix[y][x * bytePerPixel + 3] = texData.at(y).at(x).a;
+				row[x * bytePerPixel + 3] = texData.at(y).at(x).a;
 		}
 	}
-	hasImageData = true;
 }
 
 void ImageBackend::InitEmptyRGBImage(uint32_t nWidth, uint32_t nHeight, bool alpha)
@@ -284,13 +354,7 @@ void ImageBackend::InitEmptyRGBImage(uint32_t nWidth, uint32_t nHeight, bool alp
 
 	size_t bytePerPixel = GetBytesPerPixel();
 
-	pixelMatrix = static_cast<uint8_t**>(malloc(sizeof(uint8_t*) * height));
-	for (size_t y = 0; y < height; y++)
-	{
-		pixelMatrix[y] = static_cast<uint8_t*>(calloc(width * bytePerPixel, sizeof(uint8_t*)));
-	}
-
-	hasImageData = true;
+	AllocImageData(width * bytePerPixel);
 }
 
 void ImageBackend::InitEmptyPaletteImage(uint32_t nWidth, uint32_t nHeight)
@@ -304,15 +368,10 @@ void ImageBackend::InitEmptyPaletteImage(uint32_t nWidth, uint32_t nHeight)
 
 	size_t bytePerPixel = GetBytesPerPixel();
 
-	pixelMatrix = (uint8_t**)malloc(sizeof(uint8_t*) * height);
-	for (size_t y = 0; y < height; y++)
-	{
-		pixelMatrix[y] = static_cast<uint8_t*>(calloc(width * bytePerPixel, sizeof(uint8_t*)));
-	}
-	colorPalette = calloc(paletteSize, sizeof(png_color));
-	alphaPalette = static_cast<uint8_t*>(calloc(paletteSize, sizeof(uint8_t)));
+	AllocImageData(width * bytePerPixel);
+	colorPalette.assign(paletteSize * sizeof(png_color), 0);
+	alphaPalette.assign(paletteSize, 0);
 
-	hasImageData = true;
 	isColorIndexed = true;
 }
 
@@ -324,11 +383,12 @@ RGBAPixel ImageBackend::GetPixel(size_t y, size_t x) const
 
 	RGBAPixel pixel;
 	size_t bytePerPixel = GetBytesPerPixel();
-	pixel.r = pixelMatrix[y][x * bytePerPixel + 0];
-	pixel.g = pixelMatrix[y][x * bytePerPixel + 1];
-	pixel.b = pixelMatrix[y][x * bytePerPixel + 2];
+	const uint8_t* data = GetRowData(y) + x * bytePerPixel;
+	pixel.r = data[0];
+	pixel.g = data[1];
+	pixel.b = data[2];
 	if (colorType == PNG_COLOR_TYPE_RGBA)
-		pixel.a = pixelMatrix[y][x * bytePerPixel + 3];
+		pixel.a = data[3];
 	return pixel;
 }
 
@@ -338,7 +398,47 @@ uint8_t ImageBackend::GetIndexedPixel(size_t y, size_t x) const
 	assert(x < width);
 	assert(isColorIndexed);
 
-	return pixelMatrix[y][x];
+	return GetRowData(y)[x];
+}
+
+RGBAPixel ImageBackend::GetPaletteColor(size_t index) const
+{
+	assert(isColorIndexed);
+	assert(index < paletteSize);
+
+	RGBAPixel pixel;
+	const uint8_t* color = colorPalette.data() + index * 3;
+	pixel.r = color[0];
+	pixel.g = color[1];
+	pixel.b = color[2];
+	pixel.a = alphaPalette[index];
+	return pixel;
+}
+
+uint8_t* ImageBackend::GetRowData(size_t y)
+{
+	assert(hasImageData);
+	assert(y < height);
+
+	return pixelData.data() + y * stride;
+}
+
+const uint8_t* ImageBackend::GetRowData(size_t y) const
+{
+	assert(hasImageData);
+	assert(y < height);
+
+	return pixelData.data() + y * stride;
+}
+
+const uint8_t* ImageBackend::GetPixelData() const
+{
+	return pixelData.data();
+}
+
+size_t ImageBackend::GetStride() const
+{
+	return stride;
 }
 
 void ImageBackend::SetRGBPixel(size_t y, size_t x, uint8_t nR, uint8_t nG, uint8_t nB, uint8_t nA)
@@ -348,11 +448,12 @@ void ImageBackend::SetRGBPixel(size_t y, size_t x, uint8_t nR, uint8_t nG, uint8
 	assert(x < width);
 
 	size_t bytePerPixel = GetBytesPerPixel();
-	pixelMatrix[y][x * bytePerPixel + 0] = nR;
-	pixelMatrix[y][x * bytePerPixel + 1] = nG;
-	pixelMatrix[y][x * bytePerPixel + 2] = nB;
+	uint8_t* data = GetRowData(y) + x * bytePerPixel;
+	data[0] = nR;
+	data[1] = nG;
+	data[2] = nB;
 	if (colorType == PNG_COLOR_TYPE_RGBA)
-		pixelMatrix[y][x * bytePerPixel + 3] = nA;
+		data[3] = nA;
 }
 
 void ImageBackend::SetGrayscalePixel(size_t y, size_t x, uint8_t grayscale, uint8_t alpha)
@@ -362,11 +463,12 @@ void ImageBackend::SetGrayscalePixel(size_t y, size_t x, uint8_t grayscale, uint
 	assert(x < width);
 
 	size_t bytePerPixel = GetBytesPerPixel();
-	pixelMatrix[y][x * bytePerPixel + 0] = grayscale;
-	pixelMatrix[y][x * bytePerPixel + 1] = grayscale;
-	pixelMatrix[y][x * bytePerPixel + 2] = grayscale;
+	uint8_t* data = GetRowData(y) + x * bytePerPixel;
+	data[0] = grayscale;
+	data[1] = grayscale;
+	data[2] = grayscale;
 	if (colorType == PNG_COLOR_TYPE_RGBA)
-		pixelMatrix[y][x * bytePerPixel + 3] = alpha;
+		data[3] = alpha;
 }
 
 void ImageBackend::SetIndexedPixel(size_t y, size_t x, uint8_t index, uint8_t grayscale)
@@ -376,10 +478,10 @@ void ImageBackend::SetIndexedPixel(size_t y, size_t x, uint8_t index, uint8_t gr
 	assert(x < width);
 
 	size_t bytePerPixel = GetBytesPerPixel();
-	pixelMatrix[y][x * bytePerPixel + 0] = index;
+	GetRowData(y)[x * bytePerPixel + 0] = index;
 
 	assert(index < paletteSize);
-	png_color* pal = static_cast<png_color*>(colorPalette);
+	png_color* pal = reinterpret_cast<png_color*>(colorPalette.data());
 	pal[index].red = grayscale;
 	pal[index].green = grayscale;
 	pal[index].blue = grayscale;
@@ -391,7 +493,7 @@ void ImageBackend::SetPaletteIndex(size_t index, uint8_t nR, uint8_t nG, uint8_t
 	assert(isColorIndexed);
 	assert(index < paletteSize);
 
-	png_color* pal = static_cast<png_color*>(colorPalette);
+	png_color* pal = reinterpret_cast<png_color*>(colorPalette.data());
 	pal[index].red = nR;
 	pal[index].green = nG;
 	pal[index].blue = nB;
@@ -418,11 +520,8 @@ void ImageBackend::SetPalette(const ImageBackend& pal, uint32_t offset)
 				return;
 			}
 
-			uint8_t r = pal.pixelMatrix[y][x * bytePerPixel + 0];
-			uint8_t g = pal.pixelMatrix[y][x * bytePerPixel + 1];
-			uint8_t b = pal.pixelMatrix[y][x * bytePerPixel + 2];
-			uint8_t a = pal.pixelMatrix[y][x * bytePerPixel + 3];
-			SetPaletteIndex(index + offset, r, g, b, a);
+			const uint8_t* data = pal.GetRowData(y) + x * bytePerPixel;
+			SetPaletteIndex(index + offset, data[0], data[1], data[2], data[3]);
 		}
 	}
 }
@@ -465,22 +564,37 @@ double ImageBackend::GetBytesPerPixel() const
 	}
 }
 
+void ImageBackend::AllocImageData(size_t nStride)
+{
+	stride = nStride;
+	pixelData.assign(stride * height, 0);
+	hasImageData = true;
+}
+
+std::vector<uint8_t*> ImageBackend::GetRowPointers() const
+{
+	std::vector<uint8_t*> rowPointers(height);
+
+	// libpng takes non-const rows, even when writing
+	for (size_t y = 0; y < height; y++)
+		rowPointers[y] = const_cast<uint8_t*>(GetRowData(y));
+
+	return rowPointers;
+}
+
 void ImageBackend::FreeImageData()
 {
 	if (hasImageData)
 	{
-		for (size_t y = 0; y < height; y++)
-			free(pixelMatrix[y]);
-		free(pixelMatrix);
-		pixelMatrix = nullptr;
+		pixelData.clear();
+		pixelData.shrink_to_fit();
+		stride = 0;
 	}
 
 	if (isColorIndexed)
 	{
-		free(colorPalette);
-		free(alphaPalette);
-		colorPalette = nullptr;
-		alphaPalette = nullptr;
+		colorPalette.clear();
+		alphaPalette.clear();
 		isColorIndexed = false;
 	}
 
@@ -19,6 +19,30 @@ public:
 	uint8_t a = 0;
 };
 
+enum class PngCompression
+{
+	Fast,     // zlib level 1, for quick iteration
+	Default,  // zlib's default level
+	Max,      // zlib level 9, for the smallest files
+};
+
+enum class PngFilter
+{
+	Auto,  // No filtering with Fast, libpng's default otherwise
+	None,
+	Sub,
+	Up,
+	Average,
+	Paeth,
+	All,  // libpng picks the best filter for each row
+};
+
+struct PngEncodeSettings
+{
+	PngCompression compression = PngCompression::Default;
+	PngFilter filter = PngFilter::Auto;
+};
+
 class ImageBackend
 {
 public:
@@ -27,8 +51,11 @@ public:
 
 	void ReadPng(const char* filename);
 	void ReadPng(const fs::path& filename);
-	void WritePng(const char* filename);
-	void WritePng(const fs::path& filename);
+	void WritePng(const char* filename, const PngEncodeSettings& settings = {}) const;
+	void WritePng(const fs::path& filename, const PngEncodeSettings& settings = {}) const;
+
+	// Prints how many PNGs were encoded with each compression level and how long it took
+	static void PrintPngEncodeReport();
 
 	void SetTextureData(const std::vector<std::vector<RGBAPixel>>& texData, uint32_t nWidth,
 	                    uint32_t nHeight, uint8_t nColorType, uint8_t nBitDepth);
@@ -37,6 +64,16 @@ public:
 
 	RGBAPixel GetPixel(size_t y, size_t x) const;
 	uint8_t GetIndexedPixel(size_t y, size_t x) const;
+	RGBAPixel GetPaletteColor(size_t index) const;
+
+	/**
+	 * Direct access to the pixels, for bulk decoders and exporters.
+	 * Rows are stored contiguously, `GetStride()` bytes apart.
+	 */
+	uint8_t* GetRowData(size_t y);
+	const uint8_t* GetRowData(size_t y) const;
+	const uint8_t* GetPixelData() const;
+	size_t GetStride() const;
 
 	void SetRGBPixel(size_t y, size_t x, uint8_t nR, uint8_t nG, uint8_t nB, uint8_t nA = 0);
 	void SetGrayscalePixel(size_t y, size_t x, uint8_t grayscale, uint8_t alpha = 0);
@@ -52,10 +89,11 @@ public:
 	uint8_t GetBitDepth() const;
 
 protected:
-	uint8_t** pixelMatrix = nullptr;  // height * [width * bytePerPixel]
+	std::vector<uint8_t> pixelData;  // height * stride
+	size_t stride = 0;               // Bytes per row
 
-	void* colorPalette = nullptr;
-	uint8_t* alphaPalette = nullptr;
+	std::vector<uint8_t> colorPalette;  // paletteSize * [r, g, b], laid out like png_color
+	std::vector<uint8_t> alphaPalette;  // paletteSize
 	size_t paletteSize = 16 * 16;
 
 	uint32_t width = 0;
@@ -68,5 +106,10 @@ protected:
 
 	double GetBytesPerPixel() const;
 
+	// Allocates zeroed storage for `height` rows of `nStride` bytes
+	void AllocImageData(size_t nStride);
+	// The row pointers libpng expects, pointing into `pixelData`
+	std::vector<uint8_t*> GetRowPointers() const;
+
 	void FreeImageData();
 };
@@ -70,10 +70,15 @@ ZVtx vtx(nullptr);
 ZRoom room(nullptr);
 // Linker Hacks End
 
+#include "MemoryStats.h"
+#include "PngEncodeQueue.h"
+#include "Tests/SelfTest.h"
+#include "TextureCache.h"
 #include "ZFile.h"
 #include "ZTexture.h"
 
 #include <functional>
+#include <sstream>
 #include "CrashHandler.h"
 
 #include <string>
@@ -93,6 +98,7 @@ void Arg_GenerateSourceFile(int& i, char* argv[]);
 void Arg_TestMode(int& i, char* argv[]);
 void Arg_LegacyDList(int& i, char* argv[]);
 void Arg_EnableProfiling(int& i, char* argv[]);
+void Arg_EnableMemoryStats(int& i, char* argv[]);
 void Arg_UseExternalResources(int& i, char* argv[]);
 void Arg_SetTextureType(int& i, char* argv[]);
 void Arg_ReadConfigFile(int& i, char* argv[]);
@@ -106,6 +112,16 @@ void Arg_ForceUnaccountedStatic(int& i, char* argv[]);
 void Arg_SetFileListPath(int& i, char* argv[]);
 void Arg_SetBuildRawTexture(int& i, char* argv[]);
 void Arg_SetNoRomMode(int& i, char* argv[]);
+void Arg_SetBinaryOnly(int& i, char* argv[]);
+void Arg_SetPngCompression(int& i, char* argv[]);
+void Arg_SetPngFilter(int& i, char* argv[]);
+void Arg_SetPngEncodeThreads(int& i, char* argv[]);
+void Arg_EnableTextureDedup(int& i, char* argv[]);
+void Arg_SetRGBA8TextureFormats(int& i, char* argv[]);
+void Arg_EnableMeshBatches(int& i, char* argv[]);
+void Arg_EnableAudioPCM(int& i, char* argv[]);
+void Arg_EnableAudioSampleDedup(int& i, char* argv[]);
+void Arg_EnableCollisionBVH(int& i, char* argv[]);
 
 int main(int argc, char* argv[]);
 
@@ -117,6 +133,7 @@ void ParseArgs(int& argc, char* argv[]);
 void BuildAssetTexture(const fs::path& pngFilePath, TextureType texType, const fs::path& outPath);
 void BuildAssetBackground(const fs::path& imageFilePath, const fs::path& outPath);
 void BuildAssetBlob(const fs::path& blobFilePath, const fs::path& outPath);
+int BuildAssetBatch(const fs::path& inputPath, const fs::path& outPath);
 ZFileMode ParseFileMode(const std::string& buildMode, ExporterSet* exporterSet);
 int HandleExtract(ZFileMode fileMode, ExporterSet* exporterSet);
 int ExtractFunc(int workerID, int fileListSize, std::string fileListItem, ZFileMode fileMode);
@@ -133,7 +150,7 @@ extern "C" int zapd_main(int argc, char* argv[])
 
 	if (argc < 2)
 	{
-		printf("ZAPD.out (%s) [mode (btex/bovl/bsf/bblb/bmdlintr/bamnintr/e)] ...\n", gBuildHash);
+		printf("ZAPD.out (%s) [mode (btex/bovl/bsf/bblb/bbatch/bmdlintr/bamnintr/e)] ...\n", gBuildHash);
 		return 1;
 	}
 
@@ -147,6 +164,15 @@ extern "C" int zapd_main(int argc, char* argv[])
 			printf("ZAPD.out %s\n", gBuildHash);
 			return 0;
 		}
+		else if (!strcmp(argv[i], "--self-test"))
+		{
+			return SelfTest::Run() == 0 ? 0 : 1;
+		}
+		else if (!strcmp(argv[i], "--benchmark"))
+		{
+			SelfTest::RunBenchmarks();
+			return 0;
+		}
 		else if (!strcmp(argv[i], "--help") || !strcmp(argv[i], "-h"))
 		{
 			printf("Congratulations!\n");
@@ -181,6 +207,8 @@ extern "C" int zapd_main(int argc, char* argv[])
 
 	Globals::Instance->fileMode = fileMode;
 
+	PngEncodeQueueScope pngEncodeQueue(Globals::Instance->pngEncodeThreads);
+
 	if (fileMode == ZFileMode::ExtractDirectory)
 		Globals::Instance->rom = new ZRom(Globals::Instance->baseRomPath.string());
 
@@ -207,10 +235,27 @@ extern "C" int zapd_main(int argc, char* argv[])
 		BuildAssetBackground(Globals::Instance->inputPath, Globals::Instance->outputPath);
 	else if (fileMode == ZFileMode::BuildBlob)
 		BuildAssetBlob(Globals::Instance->inputPath, Globals::Instance->outputPath);
+	else if (fileMode == ZFileMode::BuildBatch)
+		returnCode = BuildAssetBatch(Globals::Instance->inputPath, Globals::Instance->outputPath);
+
+	if (!PngEncodeQueue::Finish())
+		returnCode = 1;
 
 	if (exporterSet != nullptr && exporterSet->endProgramFunc != nullptr)
 		exporterSet->endProgramFunc();
 
+	if (Globals::Instance->profile)
+	{
+		ImageBackend::PrintPngEncodeReport();
+		ZDisplayList::PrintCacheReport();
+	}
+
+	TextureCache::PrintReport();
+	ZTexture::PrintRGBA8ExportReport();
+	ZAudio::PrintSampleDedupReport();
+	ZCollisionHeader::PrintBVHReport();
+	MemoryStats::PrintReport();
+
 	delete g;
 	return returnCode;
 }
@@ -221,6 +266,8 @@ int ExtractFunc(int workerID, int fileListSize, std::string fileListItem, ZFileM
 
 	printf("(%i / %i): %s\n", (workerID + 1), fileListSize, fileListItem.c_str());
 
+	MemoryStats::BeginJob();
+
 	for (auto& extFile : Globals::Instance->cfg.externalFiles)
 	{
 		fs::path externalXmlFilePath = Globals::Instance->cfg.externalXmlFolder / extFile.xmlPath;
@@ -240,6 +287,8 @@ int ExtractFunc(int workerID, int fileListSize, std::string fileListItem, ZFileM
 	parseSuccessful = Parse(fileListItem, Globals::Instance->baseRomPath,
 	                        Globals::Instance->outputPath, fileMode, workerID);
 
+	MemoryStats::SampleJob(fileListItem);
+
 	if (!parseSuccessful)
 		return 1;
 
@@ -397,6 +446,7 @@ void ParseArgs(int& argc, char* argv[])
 		{"-tm", &Arg_TestMode},
 		{"-ulzdl", &Arg_LegacyDList},
 		{"-profile", &Arg_EnableProfiling},
+		{"-memstats", &Arg_EnableMemoryStats},
 		{"-uer", &Arg_UseExternalResources},
 		{"-tt", &Arg_SetTextureType},
 		{"-rconf", &Arg_ReadConfigFile},
@@ -414,6 +464,16 @@ void ParseArgs(int& argc, char* argv[])
 		{"-fl", &Arg_SetFileListPath},
 		{"-brt", &Arg_SetBuildRawTexture},
 		{"--norom", &Arg_SetNoRomMode},
+		{"-bo", &Arg_SetBinaryOnly},
+		{"-pngl", &Arg_SetPngCompression},
+		{"-pngf", &Arg_SetPngFilter},
+		{"-pngq", &Arg_SetPngEncodeThreads},
+		{"-tdedup", &Arg_EnableTextureDedup},
+		{"-trgba8", &Arg_SetRGBA8TextureFormats},
+		{"-dlmesh", &Arg_EnableMeshBatches},
+		{"-apcm", &Arg_EnableAudioPCM},
+		{"-adedup", &Arg_EnableAudioSampleDedup},
+		{"-colbvh", &Arg_EnableCollisionBVH},
 	};
 
 	for (int32_t i = 2; i < argc; i++)
@@ -452,6 +512,8 @@ ZFileMode ParseFileMode(const std::string& buildMode, ExporterSet* exporterSet)
 		fileMode = ZFileMode::BuildSourceFile;
 	else if (buildMode == "bblb")
 		fileMode = ZFileMode::BuildBlob;
+	else if (buildMode == "bbatch")
+		fileMode = ZFileMode::BuildBatch;
 	else if (buildMode == "e")
 		fileMode = ZFileMode::Extract;
 	else if (buildMode == "ed")
@@ -507,6 +569,12 @@ void Arg_EnableProfiling(int& i, char* argv[])
 	Globals::Instance->profile = std::string_view(argv[++i]) == "1";
 }
 
+void Arg_EnableMemoryStats(int& i, char* argv[])
+{
+	if (std::string_view(argv[++i]) == "1")
+		MemoryStats::Enable();
+}
+
 void Arg_UseExternalResources(int& i, char* argv[])
 {
 	// Split resources into their individual components(enabled by default)
@@ -575,6 +643,104 @@ void Arg_SetNoRomMode([[maybe_unused]] int& i, [[maybe_unused]] char* argv[])
 	Globals::Instance->onlyGenSohOtr = true;
 }
 
+void Arg_SetBinaryOnly(int& i, char* argv[])
+{
+	Globals::Instance->binaryOnly = std::string_view(argv[++i]) == "1";
+
+	// The binary exporters are the only consumers of a binary-only run
+	if (Globals::Instance->binaryOnly)
+		Globals::Instance->otrMode = true;
+}
+
+void Arg_SetPngCompression(int& i, char* argv[])
+{
+	std::string_view level = argv[++i];
+
+	if (level == "fast")
+		Globals::Instance->pngSettings.compression = PngCompression::Fast;
+	else if (level == "default")
+		Globals::Instance->pngSettings.compression = PngCompression::Default;
+	else if (level == "max")
+		Globals::Instance->pngSettings.compression = PngCompression::Max;
+	else
+		HANDLE_WARNING(WarningType::Always,
+		               StringHelper::Sprintf("invalid PNG compression level '%s'", argv[i]),
+		               "Valid values are 'fast', 'default' and 'max'.");
+}
+
+void Arg_SetPngFilter(int& i, char* argv[])
+{
+	static const std::map<std::string_view, PngFilter> filters = {
+		{"auto", PngFilter::Auto}, {"none", PngFilter::None},   {"sub", PngFilter::Sub},
+		{"up", PngFilter::Up},     {"avg", PngFilter::Average}, {"paeth", PngFilter::Paeth},
+		{"all", PngFilter::All},
+	};
+
+	auto filter = filters.find(argv[++i]);
+	if (filter != filters.end())
+		Globals::Instance->pngSettings.filter = filter->second;
+	else
+		HANDLE_WARNING(WarningType::Always,
+		               StringHelper::Sprintf("invalid PNG filter strategy '%s'", argv[i]),
+		               "Valid values are 'auto', 'none', 'sub', 'up', 'avg', 'paeth' and 'all'.");
+}
+
+void Arg_SetPngEncodeThreads(int& i, char* argv[])
+{
+	Globals::Instance->pngEncodeThreads = strtoul(argv[++i], nullptr, 10);
+}
+
+void Arg_EnableTextureDedup(int& i, char* argv[])
+{
+	if (std::string_view(argv[++i]) == "1")
+		TextureCache::Enable();
+}
+
+void Arg_SetRGBA8TextureFormats(int& i, char* argv[])
+{
+	static const TextureType allFormats[] = {
+		TextureType::RGBA32bpp,           TextureType::RGBA16bpp,
+		TextureType::Palette4bpp,         TextureType::Palette8bpp,
+		TextureType::Grayscale4bpp,       TextureType::Grayscale8bpp,
+		TextureType::GrayscaleAlpha4bpp,  TextureType::GrayscaleAlpha8bpp,
+		TextureType::GrayscaleAlpha16bpp,
+	};
+
+	for (const std::string& formatName : StringHelper::Split(argv[++i], ","))
+	{
+		if (formatName == "all")
+		{
+			Globals::Instance->rgba8TextureFormats.insert(std::begin(allFormats),
+			                                              std::end(allFormats));
+			continue;
+		}
+
+		TextureType format = ZTexture::GetTextureTypeFromString(formatName);
+		if (format != TextureType::Error)
+			Globals::Instance->rgba8TextureFormats.insert(format);
+	}
+}
+
+void Arg_EnableMeshBatches(int& i, char* argv[])
+{
+	Globals::Instance->exportMeshBatches = std::string_view(argv[++i]) == "1";
+}
+
+void Arg_EnableAudioPCM(int& i, char* argv[])
+{
+	Globals::Instance->exportAudioPCM = std::string_view(argv[++i]) == "1";
+}
+
+void Arg_EnableAudioSampleDedup(int& i, char* argv[])
+{
+	Globals::Instance->dedupAudioSamples = std::string_view(argv[++i]) == "1";
+}
+
+void Arg_EnableCollisionBVH(int& i, char* argv[])
+{
+	Globals::Instance->buildCollisionBVH = std::string_view(argv[++i]) == "1";
+}
+
 int HandleExtract(ZFileMode fileMode, ExporterSet* exporterSet)
 {
 	bool procFileModeSuccess = false;
@@ -683,3 +849,164 @@ void BuildAssetBlob(const fs::path& blobFilePath, const fs::path& outPath)
 
 	delete blob;
 }
+
+struct AssetBuildJob
+{
+	ZFileMode fileMode;
+	TextureType texType;
+	fs::path inputPath;
+	fs::path outputPath;
+};
+
+// Each line is one of:
+//   btex <texture type> <input png> <output>
+//   bren <input jpg> <output>
+//   bblb <input file> <output>
+// Blank lines and lines starting with '#' are ignored
+static std::vector<AssetBuildJob> ReadAssetManifest(const fs::path& manifestPath,
+                                                    std::vector<std::string>& errors)
+{
+	std::vector<AssetBuildJob> jobs;
+	std::vector<std::string> lines =
+		StringHelper::Split(DiskFile::ReadAllText(manifestPath.string()), "\n");
+
+	for (size_t lineNum = 0; lineNum < lines.size(); lineNum++)
+	{
+		std::istringstream stream(lines[lineNum]);
+		std::vector<std::string> fields;
+		std::string field;
+
+		while (stream >> field)
+			fields.push_back(field);
+
+		if (fields.empty() || fields[0][0] == '#')
+			continue;
+
+		if (fields[0] == "btex" && fields.size() == 4)
+		{
+			TextureType texType = ZTexture::GetTextureTypeFromString(fields[1]);
+
+			if (texType != TextureType::Error)
+			{
+				jobs.push_back({ZFileMode::BuildTexture, texType, fields[2], fields[3]});
+				continue;
+			}
+		}
+		else if (fields[0] == "bren" && fields.size() == 3)
+		{
+			jobs.push_back({ZFileMode::BuildBackground, TextureType::Error, fields[1], fields[2]});
+			continue;
+		}
+		else if (fields[0] == "bblb" && fields.size() == 3)
+		{
+			jobs.push_back({ZFileMode::BuildBlob, TextureType::Error, fields[1], fields[2]});
+			continue;
+		}
+
+		errors.push_back(StringHelper::Sprintf("%s:%zu: invalid entry '%s'",
+		                                       manifestPath.string().c_str(), lineNum + 1,
+		                                       lines[lineNum].c_str()));
+	}
+
+	return jobs;
+}
+
+// Uses the decomp's naming: `name.<type>.png` becomes `name.<type>.inc.c`, while `name.jpg` and
+// `name.bin` become `name.jpg.inc.c` and `name.bin.inc.c`
+static std::vector<AssetBuildJob> ListAssetDirectory(const fs::path& inputDir,
+                                                     const fs::path& outputDir,
+                                                     std::vector<std::string>& errors)
+{
+	std::vector<AssetBuildJob> jobs;
+
+	for (const std::string& file : Directory::ListFiles(inputDir.string()))
+	{
+		fs::path inputPath = file;
+		fs::path relPath = fs::relative(inputPath, inputDir);
+		std::string extension = inputPath.extension().string();
+
+		if (extension == ".png")
+		{
+			std::string stem = relPath.stem().string();
+			std::string texTypeName = fs::path(stem).extension().string();
+			TextureType texType = TextureType::Error;
+
+			if (!texTypeName.empty())
+				texType = ZTexture::GetTextureTypeFromString(texTypeName.substr(1));
+
+			if (texType == TextureType::Error)
+			{
+				errors.push_back(StringHelper::Sprintf("%s: unknown texture type", file.c_str()));
+				continue;
+			}
+
+			jobs.push_back({ZFileMode::BuildTexture, texType, inputPath,
+			                outputDir / relPath.parent_path() / (stem + ".inc.c")});
+		}
+		else if (extension == ".jpg")
+			jobs.push_back({ZFileMode::BuildBackground, TextureType::Error, inputPath,
+			                outputDir / (relPath.string() + ".inc.c")});
+		else if (extension == ".bin")
+			jobs.push_back({ZFileMode::BuildBlob, TextureType::Error, inputPath,
+			                outputDir / (relPath.string() + ".inc.c")});
+	}
+
+	return jobs;
+}
+
+int BuildAssetBatch(const fs::path& inputPath, const fs::path& outPath)
+{
+	std::vector<std::string> errors;
+	std::vector<AssetBuildJob> jobs;
+
+	if (fs::is_directory(inputPath))
+		jobs = ListAssetDirectory(inputPath, outPath, errors);
+	else
+		jobs = ReadAssetManifest(inputPath, errors);
+
+	const int num_threads = std::thread::hardware_concurrency();
+	ctpl::thread_pool pool(num_threads > 0 ? num_threads : 1);
+	std::vector<std::future<void>> results;
+
+	results.reserve(jobs.size());
+	for (const AssetBuildJob& job : jobs)
+	{
+		results.push_back(pool.push([job](int) {
+			if (job.outputPath.has_parent_path() &&
+			    !Directory::Exists(job.outputPath.parent_path()))
+				Directory::CreateDirectory(job.outputPath.parent_path().string());
+
+			if (job.fileMode == ZFileMode::BuildTexture)
+				BuildAssetTexture(job.inputPath, job.texType, job.outputPath);
+			else if (job.fileMode == ZFileMode::BuildBackground)
+				BuildAssetBackground(job.inputPath, job.outputPath);
+			else
+				BuildAssetBlob(job.inputPath, job.outputPath);
+		}));
+	}
+
+	// A failed asset doesn't stop the rest of the batch
+	size_t failedCount = 0;
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		try
+		{
+			results[i].get();
+		}
+		catch (const std::exception& e)
+		{
+			failedCount++;
+			errors.push_back(
+				StringHelper::Sprintf("%s: %s", jobs[i].inputPath.string().c_str(), e.what()));
+		}
+	}
+
+	for (const std::string& error : errors)
+		fprintf(stderr, "Error: %s\n", error.c_str());
+
+	if (Globals::Instance->verbosity >= VerbosityLevel::VERBOSITY_INFO || !errors.empty())
+		printf("Built %zu of %zu assets, %zu errors\n", jobs.size() - failedCount, jobs.size(),
+		       errors.size());
+
+	return errors.empty() ? 0 : 1;
+}
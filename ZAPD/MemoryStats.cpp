@@ -0,0 +1,321 @@
+#include "MemoryStats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#if __has_include(<unistd.h>)
+#include <sys/resource.h>
+#define HAS_POSIX 1
+#else
+#define HAS_POSIX 0
+#include <Windows.h>
+#include <Psapi.h>
+#pragma comment(lib, "Psapi.lib")
+#endif
+
+static constexpr size_t phaseCount = static_cast<size_t>(MemoryPhase::Count);
+static constexpr size_t resTypeCount = static_cast<size_t>(ZResourceType::Text) + 1;
+
+static const char* phaseNames[phaseCount] = {
+	"Other", "Construct", "ParseXML", "ParseRawData", "Declare", "GenerateSource", "Export",
+};
+
+static const char* resTypeNames[resTypeCount] = {
+	"None",
+	"Animation",
+	"Array",
+	"AltHeader",
+	"Background",
+	"Blob",
+	"CollisionHeader",
+	"Cutscene",
+	"DisplayList",
+	"Limb",
+	"LimbTable",
+	"Mtx",
+	"Path",
+	"PlayerAnimationData",
+	"Room",
+	"RoomCommand",
+	"Scalar",
+	"Scene",
+	"Skeleton",
+	"String",
+	"Symbol",
+	"Texture",
+	"TextureAnimation",
+	"TextureAnimationParams",
+	"Vector",
+	"Vertex",
+	"Audio",
+	"ActorList",
+	"CollisionPoly",
+	"Pointer",
+	"SurfaceType",
+	"Waterbox",
+	"Text",
+};
+
+// Everything here is constant-initialized, so the allocator hook is safe to use during static
+// initialization.
+static std::atomic<bool> statsEnabled{false};
+static std::atomic<uint64_t> bucketCount[phaseCount][resTypeCount];
+static std::atomic<uint64_t> bucketBytes[phaseCount][resTypeCount];
+static thread_local MemoryStatsScope* currentScope = nullptr;
+static thread_local uint64_t threadAllocBytes = 0;
+static thread_local uint64_t jobStartAllocBytes = 0;
+static thread_local uint64_t jobStartPeakRssKb = 0;
+
+struct JobSample
+{
+	std::string name;
+	uint64_t allocBytes;
+	uint64_t peakRssGrowthKb;
+};
+
+static std::mutex jobSamplesMutex;
+static std::vector<JobSample>* jobSamples = nullptr;
+
+static uint64_t GetPeakRssKb()
+{
+#if HAS_POSIX == 1
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;
+#else
+	return usage.ru_maxrss;
+#endif
+#else
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return 0;
+	return counters.PeakWorkingSetSize / 1024;
+#endif
+}
+
+void MemoryStats::Enable()
+{
+	statsEnabled.store(true, std::memory_order_relaxed);
+}
+
+bool MemoryStats::IsEnabled()
+{
+	return statsEnabled.load(std::memory_order_relaxed);
+}
+
+void MemoryStats::RecordAlloc(size_t size)
+{
+	MemoryStatsScope* scope = currentScope;
+	threadAllocBytes += size;
+
+	if (scope != nullptr)
+	{
+		// Thread-local, flushed to the shared buckets when the scope ends
+		scope->allocCount++;
+		scope->allocBytes += size;
+		return;
+	}
+
+	bucketCount[0][0].fetch_add(1, std::memory_order_relaxed);
+	bucketBytes[0][0].fetch_add(size, std::memory_order_relaxed);
+}
+
+void MemoryStats::BeginJob()
+{
+	if (!IsEnabled())
+		return;
+
+	jobStartAllocBytes = threadAllocBytes;
+	jobStartPeakRssKb = GetPeakRssKb();
+}
+
+void MemoryStats::SampleJob(const std::string& jobName)
+{
+	if (!IsEnabled())
+		return;
+
+	uint64_t allocBytes = threadAllocBytes - jobStartAllocBytes;
+	uint64_t peakRssGrowthKb = GetPeakRssKb() - jobStartPeakRssKb;
+
+	std::lock_guard<std::mutex> lock(jobSamplesMutex);
+	if (jobSamples == nullptr)
+		jobSamples = new std::vector<JobSample>();
+	jobSamples->push_back({jobName, allocBytes, peakRssGrowthKb});
+}
+
+void MemoryStats::PrintReport()
+{
+	if (!IsEnabled())
+		return;
+
+	struct Bucket
+	{
+		size_t phase;
+		size_t resType;
+		uint64_t count;
+		uint64_t bytes;
+	};
+
+	std::vector<Bucket> buckets;
+	uint64_t totalCount = 0;
+	uint64_t totalBytes = 0;
+	uint64_t phaseBytes[phaseCount] = {};
+
+	for (size_t p = 0; p < phaseCount; p++)
+	{
+		for (size_t t = 0; t < resTypeCount; t++)
+		{
+			uint64_t count = bucketCount[p][t].load(std::memory_order_relaxed);
+			uint64_t bytes = bucketBytes[p][t].load(std::memory_order_relaxed);
+
+			if (count == 0)
+				continue;
+
+			buckets.push_back({p, t, count, bytes});
+			totalCount += count;
+			totalBytes += bytes;
+			phaseBytes[p] += bytes;
+		}
+	}
+
+	std::sort(buckets.begin(), buckets.end(),
+	          [](const Bucket& a, const Bucket& b) { return a.bytes > b.bytes; });
+
+	printf("Memory usage: %" PRIu64 " allocations, %" PRIu64 " KB allocated, peak RSS %" PRIu64
+	       " KB\n",
+	       totalCount, totalBytes / 1024, GetPeakRssKb());
+
+	printf("Per phase:\n");
+	for (size_t p = 0; p < phaseCount; p++)
+	{
+		if (phaseBytes[p] != 0)
+			printf("\t%-16s %10" PRIu64 " KB\n", phaseNames[p], phaseBytes[p] / 1024);
+	}
+
+	printf("Top consumers:\n");
+	for (size_t i = 0; i < buckets.size() && i < 20; i++)
+	{
+		const Bucket& bucket = buckets[i];
+		printf("\t%-16s %-24s %10" PRIu64 " allocs %10" PRIu64 " KB\n", phaseNames[bucket.phase],
+		       resTypeNames[bucket.resType], bucket.count, bucket.bytes / 1024);
+	}
+
+	std::lock_guard<std::mutex> lock(jobSamplesMutex);
+	if (jobSamples != nullptr && !jobSamples->empty())
+	{
+		std::vector<JobSample> jobs = *jobSamples;
+		std::stable_sort(jobs.begin(), jobs.end(), [](const JobSample& a, const JobSample& b) {
+			return a.allocBytes > b.allocBytes;
+		});
+
+		printf("Top jobs:\n");
+		for (size_t i = 0; i < jobs.size() && i < 10; i++)
+		{
+			printf("\t%10" PRIu64 " KB allocated, peak RSS +%8" PRIu64 " KB %s\n",
+			       jobs[i].allocBytes / 1024, jobs[i].peakRssGrowthKb, jobs[i].name.c_str());
+		}
+	}
+}
+
+MemoryStatsScope::MemoryStatsScope(MemoryPhase nPhase, ZResourceType nResType)
+	: phase(nPhase), resType(nResType)
+{
+	if (!MemoryStats::IsEnabled())
+		return;
+
+	active = true;
+	prev = currentScope;
+	currentScope = this;
+}
+
+MemoryStatsScope::~MemoryStatsScope()
+{
+	if (!active)
+		return;
+
+	currentScope = prev;
+
+	size_t p = static_cast<size_t>(phase);
+	size_t t = static_cast<size_t>(resType);
+	bucketCount[p][t].fetch_add(allocCount, std::memory_order_relaxed);
+	bucketBytes[p][t].fetch_add(allocBytes, std::memory_order_relaxed);
+}
+
+void MemoryStatsScope::SetResourceType(ZResourceType nResType)
+{
+	resType = nResType;
+}
+
+/* Global allocator hook */
+
+static void* TrackedAlloc(size_t size)
+{
+	if (statsEnabled.load(std::memory_order_relaxed))
+		MemoryStats::RecordAlloc(size);
+
+	return malloc(size == 0 ? 1 : size);
+}
+
+void* operator new(size_t size)
+{
+	void* ptr = TrackedAlloc(size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new[](size_t size)
+{
+	void* ptr = TrackedAlloc(size);
+	if (ptr == nullptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return TrackedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	free(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept
+{
+	free(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept
+{
+	free(ptr);
+}
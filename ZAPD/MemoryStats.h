@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "ZResource.h"
+
+enum class MemoryPhase
+{
+	Other,
+	Construct,
+	ParseXML,
+	ParseRawData,
+	Declare,
+	GenerateSource,
+	Export,
+	Count,
+};
+
+/**
+ * Opt-in allocation accounting (`-memstats 1`).
+ * While disabled the global allocator hook only checks a single flag.
+ */
+class MemoryStats
+{
+public:
+	static void Enable();
+	static bool IsEnabled();
+
+	// Called by the global operator new
+	static void RecordAlloc(size_t size);
+
+	/**
+	 * Measures the extraction job running on the calling thread, from BeginJob to SampleJob: the
+	 * bytes it allocated, and how much it raised the peak resident set size of the process. The
+	 * RSS growth is only the job's own in single-threaded runs.
+	 */
+	static void BeginJob();
+	static void SampleJob(const std::string& jobName);
+
+	static void PrintReport();
+};
+
+/**
+ * Attributes every allocation made by the current thread to a phase and resource type until it
+ * goes out of scope. Nested scopes take precedence over the enclosing one.
+ */
+class MemoryStatsScope
+{
+public:
+	MemoryStatsScope(MemoryPhase nPhase, ZResourceType nResType = ZResourceType::Error);
+	~MemoryStatsScope();
+
+	// Useful when the resource type is only known after construction
+	void SetResourceType(ZResourceType nResType);
+
+	MemoryPhase phase;
+	ZResourceType resType;
+	uint64_t allocCount = 0;
+	uint64_t allocBytes = 0;
+
+protected:
+	MemoryStatsScope* prev = nullptr;
+	bool active = false;
+};
@@ -305,11 +305,10 @@ void SkinAnimatedLimbData::DeclareReferences(const std::string& prefix)
 	{
 		uint32_t dlist_Offset = Seg2Filespace(dlist, parent->baseAddress);
 
-		int32_t dlistLength = ZDisplayList::GetDListLength(
-			parent->GetRawData(), dlist_Offset,
-			Globals::Instance->game == ZGame::OOT_SW97 ? DListType::F3DEX : DListType::F3DZEX);
 		ZDisplayList* dlist_data = new ZDisplayList(parent);
-		dlist_data->ExtractFromBinary(dlist_Offset, dlistLength);
+		dlist_data->ExtractFromBinary(dlist_Offset, Globals::Instance->game == ZGame::OOT_SW97 ?
+		                                                DListType::F3DEX :
+		                                                DListType::F3DZEX);
 
 		std::string dListStr =
 			StringHelper::Sprintf("%sSkinLimbDL_%06X", varPrefix.c_str(), dlist_Offset);
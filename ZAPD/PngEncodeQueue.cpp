@@ -0,0 +1,117 @@
+#include "PngEncodeQueue.h"
+
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Utils/StringHelper.h"
+
+struct PngEncodeJob
+{
+	ImageBackend image;
+	fs::path filename;
+	PngEncodeSettings settings;
+};
+
+static std::mutex queueMutex;
+static std::condition_variable queueCondition;
+static std::deque<PngEncodeJob> queueJobs;
+static std::vector<std::thread> queueThreads;
+static bool queueStopping = false;
+static std::string queueFirstError;
+
+static void EncodeWorker()
+{
+	while (true)
+	{
+		PngEncodeJob job;
+
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			queueCondition.wait(lock, [] { return queueStopping || !queueJobs.empty(); });
+
+			if (queueJobs.empty())
+				return;
+
+			job = std::move(queueJobs.front());
+			queueJobs.pop_front();
+		}
+
+		try
+		{
+			job.image.WritePng(job.filename, job.settings);
+		}
+		catch (const std::exception& e)
+		{
+			std::lock_guard<std::mutex> lock(queueMutex);
+			if (queueFirstError.empty())
+				queueFirstError = StringHelper::Sprintf("%s: %s", job.filename.string().c_str(), e.what());
+		}
+	}
+}
+
+void PngEncodeQueue::Start(size_t threadCount)
+{
+	if (IsRunning() || threadCount == 0)
+		return;
+
+	queueStopping = false;
+	for (size_t i = 0; i < threadCount; i++)
+		queueThreads.emplace_back(EncodeWorker);
+}
+
+bool PngEncodeQueue::IsRunning()
+{
+	return !queueThreads.empty();
+}
+
+void PngEncodeQueue::Push(const ImageBackend& image, const fs::path& filename,
+                          const PngEncodeSettings& settings)
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queueJobs.push_back({image, filename, settings});
+	}
+
+	queueCondition.notify_one();
+}
+
+bool PngEncodeQueue::Finish()
+{
+	if (!IsRunning())
+		return true;
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		queueStopping = true;
+	}
+	queueCondition.notify_all();
+
+	// The workers drain the queue before exiting
+	for (std::thread& thread : queueThreads)
+		thread.join();
+	queueThreads.clear();
+
+	if (!queueFirstError.empty())
+	{
+		printf("Error: PngEncodeQueue: failed to write %s\n", queueFirstError.c_str());
+		queueFirstError.clear();
+		return false;
+	}
+
+	return true;
+}
+
+PngEncodeQueueScope::PngEncodeQueueScope(size_t threadCount)
+{
+	PngEncodeQueue::Start(threadCount);
+}
+
+PngEncodeQueueScope::~PngEncodeQueueScope()
+{
+	// A failure has already been reported by the time the scope is left normally
+	PngEncodeQueue::Finish();
+}
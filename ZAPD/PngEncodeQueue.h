@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+
+#include "ImageBackend.h"
+
+/**
+ * Encodes PNG files on background threads (`-pngq N`), so compression overlaps with parsing.
+ * Images are copied into the queue, so the caller is free to modify or destroy them.
+ */
+class PngEncodeQueue
+{
+public:
+	static void Start(size_t threadCount);
+	static bool IsRunning();
+
+	static void Push(const ImageBackend& image, const fs::path& filename,
+	                 const PngEncodeSettings& settings);
+
+	// Waits for every pending encode and stops the threads. Returns false if any of them failed
+	static bool Finish();
+};
+
+/**
+ * Runs the queue for the lifetime of the scope. The threads are joined on every way out of it,
+ * including exceptions, as destroying them while joinable would terminate the program.
+ */
+class PngEncodeQueueScope
+{
+public:
+	PngEncodeQueueScope(size_t threadCount);
+	~PngEncodeQueueScope();
+};
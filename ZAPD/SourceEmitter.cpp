@@ -0,0 +1,89 @@
+#include "SourceEmitter.h"
+
+#include <cstring>
+
+struct DigitTables
+{
+	char hex[256][2];
+	char dec[100][2];
+
+	constexpr DigitTables() : hex(), dec()
+	{
+		const char hexDigits[] = "0123456789ABCDEF";
+
+		for (size_t i = 0; i < 256; i++)
+		{
+			hex[i][0] = hexDigits[i >> 4];
+			hex[i][1] = hexDigits[i & 0xF];
+		}
+
+		for (size_t i = 0; i < 100; i++)
+		{
+			dec[i][0] = '0' + i / 10;
+			dec[i][1] = '0' + i % 10;
+		}
+	}
+};
+
+static constexpr DigitTables digitTables;
+
+char* SourceEmitter::Hex(char* dst, uint64_t value, size_t minDigits)
+{
+	size_t digits = 1;
+	for (uint64_t rest = value >> 4; rest != 0; rest >>= 4)
+		digits++;
+
+	while (minDigits > digits)
+	{
+		*dst++ = '0';
+		minDigits--;
+	}
+
+	// Fill from the end, a byte at a time
+	char* end = dst + digits;
+	char* pos = end;
+
+	for (; digits >= 2; digits -= 2, value >>= 8)
+	{
+		pos -= 2;
+		memcpy(pos, digitTables.hex[value & 0xFF], 2);
+	}
+
+	if (digits != 0)
+		*--pos = digitTables.hex[value & 0xF][1];
+
+	return end;
+}
+
+char* SourceEmitter::Dec(char* dst, int64_t value)
+{
+	uint64_t magnitude = static_cast<uint64_t>(value);
+
+	if (value < 0)
+	{
+		*dst++ = '-';
+		magnitude = 0 - magnitude;
+	}
+
+	char buffer[maxDecLength];
+	char* pos = buffer + sizeof(buffer);
+
+	while (magnitude >= 100)
+	{
+		pos -= 2;
+		memcpy(pos, digitTables.dec[magnitude % 100], 2);
+		magnitude /= 100;
+	}
+
+	if (magnitude >= 10)
+	{
+		pos -= 2;
+		memcpy(pos, digitTables.dec[magnitude], 2);
+	}
+	else
+		*--pos = '0' + magnitude;
+
+	size_t length = buffer + sizeof(buffer) - pos;
+	memcpy(dst, pos, length);
+	return dst + length;
+}
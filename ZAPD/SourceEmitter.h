@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Table-driven number formatting for large array bodies.
+ * Each function writes at `dst` without a terminator and returns the end of what it wrote, so
+ * callers can fill a buffer sized up front instead of appending one Sprintf result at a time.
+ * The output matches the printf conversion named next to each function.
+ */
+class SourceEmitter
+{
+public:
+	// The longest output of Dec, i.e. "-9223372036854775808"
+	static constexpr size_t maxDecLength = 20;
+
+	// "%0*X": uppercase hex, zero-padded to `minDigits`
+	static char* Hex(char* dst, uint64_t value, size_t minDigits);
+	// "%i"/"%lli"
+	static char* Dec(char* dst, int64_t value);
+
+	// Copies a string literal, not including its terminator
+	template <size_t N>
+	static char* Text(char* dst, const char (&text)[N])
+	{
+		for (size_t i = 0; i + 1 < N; i++)
+			*dst++ = text[i];
+		return dst;
+	}
+
+	/**
+	 * Hands `fill` a buffer of `maxSize` bytes at the end of `out`, then trims `out` to what
+	 * was written. `fill` takes a `char*` and returns the end of its output.
+	 */
+	template <typename F>
+	static void Append(std::string& out, size_t maxSize, F fill)
+	{
+		size_t start = out.size();
+		out.resize(start + maxSize);
+		char* end = fill(&out[start]);
+		out.resize(end - out.data());
+	}
+};
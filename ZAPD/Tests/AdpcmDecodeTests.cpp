@@ -0,0 +1,155 @@
+#include "SelfTest.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "AdpcmDecode.h"
+#include "ZAudio.h"
+
+/*
+ * The vadpcm decoder from the SDK tools, one sample at a time: each output is the inner product
+ * of its row of the expanded book with the previous outputs and the residuals before it, plus its
+ * own residual. The only change is the 16-bit saturation of every output, which the RSP does.
+ */
+static void ReferenceDecodeFrame(const uint8_t* frame, size_t frameSize, const AdpcmBook& book,
+                                 int32_t* state, int16_t* dst)
+{
+	const int32_t order = book.order;
+	const int32_t scale = 1 << (frame[0] >> 4);
+	const int32_t predictor = frame[0] & 0x0F;
+	const int16_t* coefs = book.books.data() + predictor * order * 8;
+
+	int32_t ix[16];
+	for (int32_t i = 0; i < 16; i++)
+	{
+		if (frameSize == 5)
+		{
+			int32_t bits = (frame[1 + i / 4] >> (6 - 2 * (i % 4))) & 3;
+			ix[i] = (bits >= 2 ? bits - 4 : bits) * scale;
+		}
+		else
+		{
+			int32_t bits = (frame[1 + i / 2] >> (4 - 4 * (i % 2))) & 0xF;
+			ix[i] = (bits >= 8 ? bits - 16 : bits) * scale;
+		}
+	}
+
+	// table[i][k]: coefficient of input `k` for output row `i`, as the SDK expands the book
+	std::vector<std::vector<int64_t>> table(8, std::vector<int64_t>(order + 8, 0));
+	for (int32_t i = 0; i < 8; i++)
+	{
+		for (int32_t k = 0; k < order; k++)
+			table[i][k] = coefs[k * 8 + i];
+	}
+	table[0][order] = 1 << 11;
+	for (int32_t i = 1; i < 8; i++)
+		table[i][order] = table[i - 1][order - 1];
+	for (int32_t k = 1; k < 8; k++)
+	{
+		for (int32_t i = k; i < 8; i++)
+			table[i][k + order] = table[i - k][order];
+	}
+
+	for (int32_t half = 0; half < 2; half++)
+	{
+		int64_t in[16];
+
+		for (int32_t i = 0; i < order; i++)
+			in[i] = half == 0 ? state[16 - order + i] : state[8 - order + i];
+		for (int32_t i = 0; i < 8; i++)
+			in[order + i] = ix[half * 8 + i];
+
+		for (int32_t i = 0; i < 8; i++)
+		{
+			int64_t total = 0;
+			for (int32_t k = 0; k < order + i; k++)
+				total += table[i][k] * in[k];
+
+			// Rounds down, like the SDK's myinner_product
+			int64_t quotient = total / (1 << 11);
+			if (quotient * (1 << 11) > total)
+				quotient--;
+
+			int64_t value = quotient + ix[half * 8 + i];
+			value = value < -0x8000 ? -0x8000 : (value > 0x7FFF ? 0x7FFF : value);
+			state[half * 8 + i] = static_cast<int32_t>(value);
+			dst[half * 8 + i] = static_cast<int16_t>(value);
+		}
+	}
+}
+
+static uint32_t NextPattern(uint32_t& seed)
+{
+	seed = seed * 1664525 + 1013904223;
+	return seed >> 8;
+}
+
+static void TestFrames(size_t frameSize, int32_t order, int32_t npredictors, uint32_t seed)
+{
+	// Coefficients and scales in the range of the game's books, so sums stay within 32 bits
+	AdpcmBook book;
+	book.order = order;
+	book.npredictors = npredictors;
+	for (int32_t i = 0; i < 8 * order * npredictors; i++)
+		book.books.push_back(static_cast<int16_t>(NextPattern(seed) % 4096) - 2048);
+
+	// Every predictor at every scale up to 2^11, which is loud enough to saturate
+	std::vector<uint8_t> frames;
+	for (int32_t shift = 0; shift <= 11; shift++)
+	{
+		for (int32_t predictor = 0; predictor < npredictors; predictor++)
+		{
+			frames.push_back(static_cast<uint8_t>((shift << 4) | predictor));
+			for (size_t i = 1; i < frameSize; i++)
+				frames.push_back(static_cast<uint8_t>(NextPattern(seed)));
+		}
+	}
+
+	const size_t frameCount = frames.size() / frameSize;
+	std::vector<int16_t> expected(frameCount * 16);
+	std::vector<int32_t> state(16, 0);
+	for (size_t f = 0; f < frameCount; f++)
+	{
+		ReferenceDecodeFrame(&frames[f * frameSize], frameSize, book, state.data(),
+		                     &expected[f * 16]);
+	}
+
+	// One call for all frames, and one call per frame carrying the history over
+	const std::vector<int32_t> coefs = AdpcmDecode::ExpandBook(book);
+	std::vector<int16_t> whole(frameCount * 16);
+	std::vector<int16_t> history(order, 0);
+	AdpcmDecode::DecodeFrames(frames.data(), frameCount, frameSize, coefs, order, npredictors,
+	                          history.data(), whole.data());
+	SELFTEST_CHECK(whole == expected);
+
+	std::vector<int16_t> split(frameCount * 16);
+	std::fill(history.begin(), history.end(), 0);
+	for (size_t f = 0; f < frameCount; f++)
+	{
+		AdpcmDecode::DecodeFrames(&frames[f * frameSize], 1, frameSize, coefs, order, npredictors,
+		                          history.data(), &split[f * 16]);
+	}
+	SELFTEST_CHECK(split == expected);
+}
+
+void TestAdpcmDecode()
+{
+	// With an all-zero book each output is only its own residual times the scale
+	SampleEntry silent;
+	silent.codec = 0;
+	silent.book.order = 2;
+	silent.book.npredictors = 1;
+	silent.book.books.assign(16, 0);
+	silent.loop = {};
+	silent.data = {0x20, 0x01, 0x23, 0x45, 0x67, 0x89, 0xAB, 0xCD, 0xEF};
+
+	const std::vector<int16_t> residuals = {0, 4,  8,   12,  16,  20,  24,  28,
+	                                        -32, -28, -24, -20, -16, -12, -8, -4};
+	SELFTEST_CHECK(AdpcmDecode::DecodeSample(silent) == residuals);
+
+	for (size_t frameSize : {9, 5})
+	{
+		for (int32_t order = 1; order <= 8; order++)
+			TestFrames(frameSize, order, 1 + order % 4, 0x1234 + order);
+	}
+}
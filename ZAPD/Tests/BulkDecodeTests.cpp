@@ -0,0 +1,185 @@
+#include "SelfTest.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+#include "BulkDecode.h"
+
+// The expected values are built with shifts, so they hold on hosts of either byte order
+
+static void WriteBE16(uint8_t* dst, uint16_t value)
+{
+	dst[0] = value >> 8;
+	dst[1] = value & 0xFF;
+}
+
+static void WriteBE32(uint8_t* dst, uint32_t value)
+{
+	dst[0] = value >> 24;
+	dst[1] = (value >> 16) & 0xFF;
+	dst[2] = (value >> 8) & 0xFF;
+	dst[3] = value & 0xFF;
+}
+
+// A value with a different byte in every position, so a missing or extra swap shows
+static uint32_t PatternValue(size_t i)
+{
+	return static_cast<uint32_t>(i * 0x9E3779B1 + 0x01020304);
+}
+
+static void TestSwap(size_t count)
+{
+	std::vector<uint8_t> src16(count * 2);
+	std::vector<uint8_t> src32(count * 4);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		WriteBE16(&src16[i * 2], static_cast<uint16_t>(PatternValue(i)));
+		WriteBE32(&src32[i * 4], PatternValue(i));
+	}
+
+	// One extra element after each output, which must be left alone
+	std::vector<uint16_t> u16(count + 1, 0xAAAA);
+	std::vector<int16_t> s16(count + 1, 0x5555);
+	std::vector<uint32_t> u32(count + 1, 0xAAAAAAAA);
+	std::vector<int32_t> s32(count + 1, 0x55555555);
+	std::vector<float> f32(count + 1, 1.0f);
+
+	BulkDecode::SwapU16(src16.data(), u16.data(), count);
+	BulkDecode::SwapS16(src16.data(), s16.data(), count);
+	BulkDecode::SwapU32(src32.data(), u32.data(), count);
+	BulkDecode::SwapS32(src32.data(), s32.data(), count);
+	BulkDecode::SwapFloat(src32.data(), f32.data(), count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		uint32_t value = PatternValue(i);
+		uint32_t floatBits;
+		memcpy(&floatBits, &f32[i], sizeof(floatBits));
+
+		SELFTEST_CHECK(u16[i] == static_cast<uint16_t>(value));
+		SELFTEST_CHECK(s16[i] == static_cast<int16_t>(value));
+		SELFTEST_CHECK(u32[i] == value);
+		SELFTEST_CHECK(s32[i] == static_cast<int32_t>(value));
+		SELFTEST_CHECK(floatBits == value);
+	}
+
+	SELFTEST_CHECK(u16[count] == 0xAAAA);
+	SELFTEST_CHECK(s16[count] == 0x5555);
+	SELFTEST_CHECK(u32[count] == 0xAAAAAAAA);
+	SELFTEST_CHECK(s32[count] == 0x55555555);
+	SELFTEST_CHECK(f32[count] == 1.0f);
+}
+
+static void TestStrided(size_t count)
+{
+	const size_t stride = 12;
+	std::vector<uint8_t> src(count * stride, 0xEE);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		WriteBE16(&src[i * stride + 2], static_cast<uint16_t>(PatternValue(i)));
+		WriteBE32(&src[i * stride + 4], PatternValue(i));
+	}
+
+	std::vector<uint16_t> u16(count);
+	std::vector<int16_t> s16(count);
+	std::vector<uint32_t> u32(count);
+
+	BulkDecode::ExtractU16Strided(src.data() + 2, stride, u16.data(), count);
+	BulkDecode::ExtractS16Strided(src.data() + 2, stride, s16.data(), count);
+	BulkDecode::ExtractU32Strided(src.data() + 4, stride, u32.data(), count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		SELFTEST_CHECK(u16[i] == static_cast<uint16_t>(PatternValue(i)));
+		SELFTEST_CHECK(s16[i] == static_cast<int16_t>(PatternValue(i)));
+		SELFTEST_CHECK(u32[i] == PatternValue(i));
+	}
+}
+
+static void TestRecords(size_t count)
+{
+	std::vector<uint8_t> src(count * 16);
+
+	for (size_t i = 0; i < count * 8; i++)
+		WriteBE16(&src[i * 2], static_cast<uint16_t>(PatternValue(i)));
+
+	std::vector<uint16_t> fields[8];
+	uint16_t* fieldPtrs[8];
+	for (size_t n = 0; n < 8; n++)
+	{
+		fields[n].resize(count);
+		fieldPtrs[n] = fields[n].data();
+	}
+
+	BulkDecode::DeinterleaveU16x8(src.data(), fieldPtrs, count);
+
+	for (size_t i = 0; i < count; i++)
+	{
+		for (size_t n = 0; n < 8; n++)
+			SELFTEST_CHECK(fields[n][i] == static_cast<uint16_t>(PatternValue(i * 8 + n)));
+	}
+
+	// Odd record sizes too, where the last byte is never a field
+	for (size_t recordSize : {16, 10, 7})
+	{
+		const uint32_t fieldMask = 0x2B;
+		std::vector<uint8_t> dst(count * recordSize);
+
+		BulkDecode::SwapU16Fields(src.data(), dst.data(), count, recordSize, fieldMask);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			for (size_t n = 0; n * 2 + 1 < recordSize; n++)
+			{
+				size_t offset = i * recordSize + n * 2;
+				uint16_t value;
+				memcpy(&value, &dst[offset], sizeof(value));
+
+				if (fieldMask & (1 << n))
+					SELFTEST_CHECK(value == ((src[offset] << 8) | src[offset + 1]));
+				else
+					SELFTEST_CHECK(memcmp(&dst[offset], &src[offset], 2) == 0);
+			}
+
+			if (recordSize % 2 != 0)
+			{
+				size_t last = i * recordSize + recordSize - 1;
+				SELFTEST_CHECK(dst[last] == src[last]);
+			}
+		}
+	}
+}
+
+void TestBulkDecode()
+{
+	// Around the vector widths, so both the vector loops and their scalar tails run
+	for (size_t count : {0, 1, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 100})
+	{
+		TestSwap(count);
+		TestStrided(count);
+		TestRecords(count);
+	}
+
+	std::vector<uint8_t> data(8);
+	WriteBE16(&data[2], 0x8001);
+	WriteBE16(&data[4], 0x7FFE);
+
+	std::vector<int16_t> s16 = BulkDecode::ReadS16Array(data, 2, 2);
+	std::vector<uint16_t> u16 = BulkDecode::ReadU16Array(data, 2, 2);
+	SELFTEST_CHECK(s16.size() == 2 && s16[0] == -0x7FFF && s16[1] == 0x7FFE);
+	SELFTEST_CHECK(u16.size() == 2 && u16[0] == 0x8001 && u16[1] == 0x7FFE);
+
+	bool threw = false;
+	try
+	{
+		BulkDecode::CheckBounds(data, 4, 5, "TestBulkDecode");
+	}
+	catch (const std::exception&)
+	{
+		threw = true;
+	}
+	SELFTEST_CHECK(threw);
+}
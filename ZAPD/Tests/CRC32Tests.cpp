@@ -0,0 +1,80 @@
+#include "SelfTest.h"
+
+#include <cstring>
+#include <vector>
+
+#include "CRC32.h"
+
+// The original bit-by-bit CRC32B, which the texture pool hashes were made with
+static uint32_t ReferenceCRC32B(const unsigned char* message, int32_t size)
+{
+	int32_t byte, crc;
+	int32_t mask;
+
+	crc = 0xFFFFFFFF;
+
+	for (int32_t i = 0; i < size; i++)
+	{
+		byte = message[i];
+		crc = crc ^ byte;
+
+		for (int32_t j = 7; j >= 0; j--)
+		{
+			mask = -(crc & 1);
+			crc = (crc >> 1) ^ (0xEDB88320 & mask);
+		}
+	}
+
+	return ~(uint32_t)(crc);
+}
+
+static std::vector<unsigned char> MakePattern(size_t size)
+{
+	std::vector<unsigned char> data(size);
+	for (size_t i = 0; i < size; i++)
+		data[i] = static_cast<unsigned char>(i * 0x9E3779B1 >> 24);
+	return data;
+}
+
+void TestCRC32()
+{
+	const unsigned char check[] = "123456789";
+	const unsigned char zeros[32] = {};
+	unsigned char ones[32];
+	memset(ones, 0xFF, sizeof(ones));
+
+	// Pinned, so a change to both implementations still shows. Not the standard CRC-32 values,
+	// see CRC32.h
+	SELFTEST_CHECK(CRC32B(check, 9) == 0xF273791B);
+	SELFTEST_CHECK(CRC32B(zeros, 32) == 0xF7477D51);
+	SELFTEST_CHECK(CRC32B(ones, 32) == 0x00000000);
+	SELFTEST_CHECK(CRC32B(zeros, 0) == 0x00000000);
+	SELFTEST_CHECK(CRC32B(zeros, -1) == 0x00000000);
+
+	// Every length around the 8-byte blocks, from every alignment
+	std::vector<unsigned char> data = MakePattern(4096 + 8);
+	for (size_t start = 0; start < 8; start++)
+	{
+		for (int32_t size = 0; size <= 72; size++)
+			SELFTEST_CHECK(CRC32B(&data[start], size) == ReferenceCRC32B(&data[start], size));
+	}
+	SELFTEST_CHECK(CRC32B(data.data(), 4096) == ReferenceCRC32B(data.data(), 4096));
+
+	// Runs of set sign bits, where the running CRC stays negative for many blocks
+	std::vector<unsigned char> mostlyOnes(256, 0xFF);
+	for (size_t i = 0; i < mostlyOnes.size(); i += 37)
+		mostlyOnes[i] = static_cast<unsigned char>(i);
+	for (int32_t size = 0; size <= 256; size += 5)
+		SELFTEST_CHECK(CRC32B(mostlyOnes.data(), size) == ReferenceCRC32B(mostlyOnes.data(), size));
+}
+
+void BenchmarkCRC32()
+{
+	std::vector<unsigned char> data = MakePattern(1024 * 1024);
+	int32_t size = static_cast<int32_t>(data.size());
+	volatile uint32_t sink;
+
+	SelfTest::Benchmark("CRC32B", data.size(), [&]() { sink = CRC32B(data.data(), size); });
+	SelfTest::Benchmark("CRC32B bit by bit", data.size(),
+	                    [&]() { sink = ReferenceCRC32B(data.data(), size); });
+}
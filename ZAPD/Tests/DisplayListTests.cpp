@@ -0,0 +1,175 @@
+#include "SelfTest.h"
+
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ZDisplayList.h"
+
+// A list of `count` vertices at `offset`, each one's x being its own offset divided by 16
+static std::vector<VtxData> MakeVtxRun(uint32_t offset, size_t count)
+{
+	std::vector<VtxData> list(count, VtxData {});
+
+	for (size_t i = 0; i < count; i++)
+		list[i].x = static_cast<int16_t>(offset / 16 + i);
+
+	return list;
+}
+
+struct MergeVertexListsCase
+{
+	bool mergeTouching;
+	std::vector<std::pair<uint32_t, size_t>> input;     // Offset and vertex count of each list
+	std::vector<std::pair<uint32_t, size_t>> expected;  // Same, after merging
+};
+
+void TestMergeVertexLists()
+{
+	const MergeVertexListsCase cases[] = {
+		// Disjoint
+		{true, {{0x00, 2}, {0x30, 2}}, {{0x00, 2}, {0x30, 2}}},
+		// Nested, inside and at the end
+		{false, {{0x00, 4}, {0x10, 1}}, {{0x00, 4}}},
+		{false, {{0x00, 4}, {0x20, 2}}, {{0x00, 4}}},
+		// Touching, kept apart unless `mergeTouching` is set
+		{false, {{0x00, 2}, {0x20, 2}}, {{0x00, 2}, {0x20, 2}}},
+		{true, {{0x00, 2}, {0x20, 2}}, {{0x00, 4}}},
+		// Overlapping
+		{false, {{0x00, 3}, {0x20, 3}}, {{0x00, 5}}},
+		// Nested, then overlapping the list it was merged into
+		{false, {{0x00, 4}, {0x10, 1}, {0x30, 3}}, {{0x00, 6}}},
+		// A chain of overlapping and touching lists, then a gap
+		{true, {{0x00, 2}, {0x10, 2}, {0x30, 1}, {0x40, 1}, {0x60, 1}}, {{0x00, 5}, {0x60, 1}}},
+	};
+
+	for (const MergeVertexListsCase& test : cases)
+	{
+		std::map<uint32_t, std::vector<VtxData>> lists;
+		for (const auto& list : test.input)
+			lists[list.first] = MakeVtxRun(list.first, list.second);
+
+		ZDisplayList::MergeVertexLists(lists, test.mergeTouching);
+
+		SELFTEST_CHECK(lists.size() == test.expected.size());
+		if (lists.size() != test.expected.size())
+			continue;
+
+		// Every merged list must be the vertices of its whole range, in order
+		auto expected = test.expected.begin();
+		for (auto it = lists.begin(); it != lists.end(); ++it, ++expected)
+		{
+			SELFTEST_CHECK(it->first == expected->first);
+			SELFTEST_CHECK(it->second.size() == expected->second);
+
+			for (size_t i = 0; i < it->second.size(); i++)
+				SELFTEST_CHECK(it->second[i].x == static_cast<int16_t>(it->first / 16 + i));
+		}
+	}
+}
+
+// The opcodes which LowerCommands reads, for one microcode
+struct LowerOpcodes
+{
+	DListType type;
+	uint8_t vtx, dl, mtx, moveMem, rdpHalf1, branchZ, endDL;
+};
+
+template <typename Opcode>
+static LowerOpcodes MakeLowerOpcodes(DListType type)
+{
+	return {type,
+	        static_cast<uint8_t>(Opcode::G_VTX),
+	        static_cast<uint8_t>(Opcode::G_DL),
+	        static_cast<uint8_t>(Opcode::G_MTX),
+	        static_cast<uint8_t>(Opcode::G_MOVEMEM),
+	        static_cast<uint8_t>(Opcode::G_RDPHALF_1),
+	        static_cast<uint8_t>(Opcode::G_BRANCH_Z),
+	        static_cast<uint8_t>(Opcode::G_ENDDL)};
+}
+
+// A command with some other bits set in its high word, which lowering must keep
+static uint64_t MakeCommand(uint8_t opcode, uint32_t w1)
+{
+	return (static_cast<uint64_t>(opcode) << 56) | (0x123456ULL << 32) | w1;
+}
+
+void TestLowerCommands()
+{
+	const uint8_t setTImg = static_cast<uint8_t>(F3DZEXOpcode::G_SETTIMG);
+	const LowerOpcodes microcodes[] = {
+		MakeLowerOpcodes<F3DZEXOpcode>(DListType::F3DZEX),
+		MakeLowerOpcodes<F3DEXOpcode>(DListType::F3DEX),
+	};
+
+	// Two resources in segment 6, nothing anywhere else
+	auto resolve = [](segptr_t address, std::string& path, uint32_t& offset) {
+		if (address >= 0x06000000 && address < 0x06000100)
+		{
+			path = "object/vtx";
+			offset = address - 0x06000000;
+			return true;
+		}
+		if (address >= 0x06000100 && address < 0x06000200)
+		{
+			path = "object/dl";
+			offset = address - 0x06000100;
+			return true;
+		}
+		return false;
+	};
+
+	for (const LowerOpcodes& op : microcodes)
+	{
+		const std::vector<uint64_t> commands = {
+			MakeCommand(op.vtx, 0x06000020),       // Inside the first resource
+			MakeCommand(op.dl, 0x06000100),        // The second resource
+			MakeCommand(op.mtx, 0x06000010),       // The first resource again, same path index
+			MakeCommand(op.moveMem, 0x06000108),   // Inside the second resource
+			MakeCommand(op.rdpHalf1, 0x06000180),  // The target of the gsSPBranchLessZ below
+			MakeCommand(op.branchZ, 0x00000000),
+			MakeCommand(op.rdpHalf1, 0x06000180),  // Not followed by G_BRANCH_Z, not an address
+			MakeCommand(setTImg, 0x09000000),      // Unresolved
+			MakeCommand(op.dl, SEGMENTED_NULL),    // Null
+			MakeCommand(op.endDL, 0x06000000),     // Not an address
+		};
+
+		DListBinary binary = ZDisplayList::LowerCommands(commands, op.type, resolve);
+
+		const std::vector<std::string> expectedPaths = {"object/vtx", "object/dl"};
+		SELFTEST_CHECK(binary.resourcePaths == expectedPaths);
+
+		// Command index, original address, path index and offset of each rewrite
+		const DListBinaryReference expectedReferences[] = {
+			{0, 0x06000020, 0, 0x20}, {1, 0x06000100, 1, 0x00}, {2, 0x06000010, 0, 0x10},
+			{3, 0x06000108, 1, 0x08}, {4, 0x06000180, 1, 0x80},
+		};
+		SELFTEST_CHECK(binary.references.size() == std::size(expectedReferences));
+		for (size_t i = 0; i < binary.references.size() && i < std::size(expectedReferences); i++)
+		{
+			const DListBinaryReference& ref = binary.references[i];
+			const DListBinaryReference& expected = expectedReferences[i];
+
+			SELFTEST_CHECK(ref.commandIndex == expected.commandIndex);
+			SELFTEST_CHECK(ref.address == expected.address);
+			SELFTEST_CHECK(ref.pathIndex == expected.pathIndex);
+			SELFTEST_CHECK(ref.offset == expected.offset);
+		}
+
+		// Rewritten commands keep their high word and hold the path index, the rest are copied
+		SELFTEST_CHECK(binary.commands.size() == commands.size());
+		for (size_t i = 0; i < binary.commands.size() && i < commands.size(); i++)
+		{
+			uint64_t expected = commands[i];
+			for (const DListBinaryReference& ref : expectedReferences)
+			{
+				if (ref.commandIndex == i)
+					expected = (expected & 0xFFFFFFFF00000000) | ref.pathIndex;
+			}
+
+			SELFTEST_CHECK(binary.commands[i] == expected);
+		}
+	}
+}
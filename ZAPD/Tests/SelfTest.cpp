@@ -0,0 +1,74 @@
+#include "SelfTest.h"
+
+#include <chrono>
+#include <cstdio>
+
+struct SelfTestCase
+{
+	const char* name;
+	void (*run)();
+};
+
+static const SelfTestCase selfTestCases[] = {
+	{"AdpcmDecode", TestAdpcmDecode},
+	{"BulkDecode", TestBulkDecode},
+	{"CRC32", TestCRC32},
+	{"LowerCommands", TestLowerCommands},
+	{"MergeVertexLists", TestMergeVertexLists},
+	{"SourceEmitter", TestSourceEmitter},
+	{"TextureDecode", TestTextureDecode},
+};
+
+static void (*const benchmarks[])() = {
+	BenchmarkCRC32,
+	BenchmarkSourceEmitter,
+};
+
+static int failedChecks = 0;
+
+int SelfTest::Run()
+{
+	failedChecks = 0;
+
+	for (const SelfTestCase& test : selfTestCases)
+	{
+		int failedBefore = failedChecks;
+		test.run();
+		printf("[%s] %s\n", failedChecks == failedBefore ? " OK " : "FAIL", test.name);
+	}
+
+	return failedChecks;
+}
+
+void SelfTest::RunBenchmarks()
+{
+	for (auto benchmark : benchmarks)
+		benchmark();
+}
+
+void SelfTest::Fail(const char* file, int line, const char* expression)
+{
+	printf("%s:%i: check failed: %s\n", file, line, expression);
+	failedChecks++;
+}
+
+void SelfTest::Benchmark(const char* name, size_t bytes, const std::function<void()>& run)
+{
+	using Clock = std::chrono::steady_clock;
+
+	// Warm up the caches first
+	run();
+
+	size_t runs = 0;
+	Clock::time_point start = Clock::now();
+	std::chrono::duration<double> elapsed;
+
+	do
+	{
+		run();
+		runs++;
+		elapsed = Clock::now() - start;
+	} while (elapsed.count() < 0.25);
+
+	printf("%-32s %10.1f MB/s\n", name, bytes * runs / elapsed.count() / (1024 * 1024));
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+/**
+ * ZAPD's built-in checks (`--self-test`, registered with CTest as ZAPD.SelfTest) and throughput
+ * benchmarks (`--benchmark`).
+ * Each module has its cases in the Tests/ file named after it.
+ */
+class SelfTest
+{
+public:
+	// Runs every case and returns the number of failed checks
+	static int Run();
+	// Runs every benchmark and prints its throughput
+	static void RunBenchmarks();
+
+	// Records a failed check, see SELFTEST_CHECK
+	static void Fail(const char* file, int line, const char* expression);
+	// Repeats `run`, which processes `bytes` bytes per call, for at least a quarter second
+	static void Benchmark(const char* name, size_t bytes, const std::function<void()>& run);
+};
+
+#define SELFTEST_CHECK(expression)                                                                 \
+	do                                                                                             \
+	{                                                                                              \
+		if (!(expression))                                                                         \
+			SelfTest::Fail(__FILE__, __LINE__, #expression);                                       \
+	} while (0)
+
+// Tests/AdpcmDecodeTests.cpp
+void TestAdpcmDecode();
+
+// Tests/BulkDecodeTests.cpp
+void TestBulkDecode();
+
+// Tests/CRC32Tests.cpp
+void TestCRC32();
+void BenchmarkCRC32();
+
+// Tests/DisplayListTests.cpp
+void TestMergeVertexLists();
+void TestLowerCommands();
+
+// Tests/SourceEmitterTests.cpp
+void TestSourceEmitter();
+void BenchmarkSourceEmitter();
+
+// Tests/TextureDecodeTests.cpp
+void TestTextureDecode();
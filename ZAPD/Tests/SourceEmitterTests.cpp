@@ -0,0 +1,148 @@
+#include "SelfTest.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "SourceEmitter.h"
+#include "Utils/StringHelper.h"
+
+static bool HexMatchesPrintf(uint64_t value, size_t minDigits)
+{
+	char expected[32];
+	char actual[32];
+
+	int expectedLength =
+		snprintf(expected, sizeof(expected), "%0*" PRIX64, static_cast<int>(minDigits), value);
+	char* end = SourceEmitter::Hex(actual, value, minDigits);
+
+	return end - actual == expectedLength && memcmp(actual, expected, expectedLength) == 0;
+}
+
+static bool DecMatchesPrintf(int64_t value)
+{
+	char expected[32];
+	char actual[32];
+
+	int expectedLength = snprintf(expected, sizeof(expected), "%" PRIi64, value);
+	char* end = SourceEmitter::Dec(actual, value);
+
+	return end - actual == expectedLength && memcmp(actual, expected, expectedLength) == 0;
+}
+
+void TestSourceEmitter()
+{
+	// Every digit count, and the values either side of each boundary
+	for (uint32_t shift = 0; shift < 64; shift += 4)
+	{
+		uint64_t boundary = uint64_t(1) << shift;
+
+		for (uint64_t value : {boundary - 1, boundary, boundary + 1, boundary * 0xF})
+		{
+			for (size_t minDigits = 0; minDigits <= 18; minDigits++)
+				SELFTEST_CHECK(HexMatchesPrintf(value, minDigits));
+		}
+	}
+	SELFTEST_CHECK(HexMatchesPrintf(std::numeric_limits<uint64_t>::max(), 16));
+	SELFTEST_CHECK(HexMatchesPrintf(0x0123456789ABCDEF, 4));
+
+	for (int64_t power = 1; power <= std::numeric_limits<int64_t>::max() / 10; power *= 10)
+	{
+		for (int64_t value : {power - 1, power, power + 1, power * 9})
+		{
+			SELFTEST_CHECK(DecMatchesPrintf(value));
+			SELFTEST_CHECK(DecMatchesPrintf(-value));
+		}
+	}
+	SELFTEST_CHECK(DecMatchesPrintf(std::numeric_limits<int64_t>::max()));
+	SELFTEST_CHECK(DecMatchesPrintf(std::numeric_limits<int64_t>::min()));
+
+	std::string out = "{ ";
+	SourceEmitter::Append(out, 64, [](char* dst) {
+		dst = SourceEmitter::Text(dst, "0x");
+		dst = SourceEmitter::Hex(dst, 0xBEEF, 8);
+		dst = SourceEmitter::Text(dst, ", ");
+		return SourceEmitter::Dec(dst, -42);
+	});
+	SELFTEST_CHECK(out == "{ 0x0000BEEF, -42");
+}
+
+// The ZBlob and ZTexture array bodies, with SourceEmitter and with the Sprintf calls it replaced
+void BenchmarkSourceEmitter()
+{
+	std::vector<uint8_t> data(64 * 1024);
+	for (size_t i = 0; i < data.size(); i++)
+		data[i] = static_cast<uint8_t>(i * 0x9E3779B1 >> 24);
+
+	std::string out;
+
+	SelfTest::Benchmark("SourceEmitter u8 array", data.size(), [&]() {
+		out.clear();
+		SourceEmitter::Append(out, data.size() * 8, [&](char* dst) {
+			for (size_t i = 0; i < data.size(); i++)
+			{
+				if (i % 16 == 0)
+					*dst++ = '\t';
+				dst = SourceEmitter::Hex(SourceEmitter::Text(dst, "0x"), data[i], 2);
+				dst = SourceEmitter::Text(dst, ", ");
+				if (i % 16 == 15)
+					*dst++ = '\n';
+			}
+			return dst;
+		});
+	});
+
+	SelfTest::Benchmark("Sprintf u8 array", data.size(), [&]() {
+		out.clear();
+		for (size_t i = 0; i < data.size(); i++)
+		{
+			if (i % 16 == 0)
+				out += "\t";
+			out += StringHelper::Sprintf("0x%02X, ", data[i]);
+			if (i % 16 == 15)
+				out += "\n";
+		}
+	});
+
+	SelfTest::Benchmark("SourceEmitter u64 array", data.size(), [&]() {
+		out.clear();
+		SourceEmitter::Append(out, data.size() / 8 * 40, [&](char* dst) {
+			for (size_t i = 0; i < data.size(); i += 8)
+			{
+				uint64_t value = 0;
+				for (size_t j = i; j < i + 8; j++)
+					value = (value << 8) | data[j];
+
+				if (i % 32 == 0)
+					dst = SourceEmitter::Text(dst, "    ");
+				dst = SourceEmitter::Hex(SourceEmitter::Text(dst, "0x"), value, 16);
+				dst = SourceEmitter::Text(dst, ", ");
+				if (i % 32 == 24)
+				{
+					dst = SourceEmitter::Hex(SourceEmitter::Text(dst, " // 0x"), i - 24, 6);
+					dst = SourceEmitter::Text(dst, " \n");
+				}
+			}
+			return dst;
+		});
+	});
+
+	SelfTest::Benchmark("Sprintf u64 array", data.size(), [&]() {
+		out.clear();
+		for (size_t i = 0; i < data.size(); i += 8)
+		{
+			uint64_t value = 0;
+			for (size_t j = i; j < i + 8; j++)
+				value = (value << 8) | data[j];
+
+			if (i % 32 == 0)
+				out += "    ";
+			out += StringHelper::Sprintf("0x%016llX, ", static_cast<unsigned long long>(value));
+			if (i % 32 == 24)
+				out += StringHelper::Sprintf(" // 0x%06X \n", static_cast<uint32_t>(i - 24));
+		}
+	});
+}
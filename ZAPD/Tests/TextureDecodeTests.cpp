@@ -0,0 +1,160 @@
+#include "SelfTest.h"
+
+#include <cstring>
+#include <vector>
+
+#include "TextureDecode.h"
+
+// Per-pixel references, following the original ZTexture::ConvertN64ToBitmap_* loops
+
+static uint8_t ReferenceNibble(const uint8_t* src, size_t i)
+{
+	return (i % 2 == 0) ? (src[i / 2] & 0xF0) >> 4 : src[i / 2] & 0x0F;
+}
+
+static void ReferenceRGBA16(const uint8_t* src, size_t i, uint8_t* dst)
+{
+	uint16_t data = src[i * 2 + 1] | (src[i * 2] << 8);
+	uint8_t r = (data & 0xF800) >> 11;
+	uint8_t g = (data & 0x07C0) >> 6;
+	uint8_t b = (data & 0x003E) >> 1;
+
+	dst[0] = (r << 3) | (r >> 2);
+	dst[1] = (g << 3) | (g >> 2);
+	dst[2] = (b << 3) | (b >> 2);
+	dst[3] = (data & 0x01) * 255;
+}
+
+static void ReferenceRGBA32(const uint8_t* src, size_t i, uint8_t* dst)
+{
+	memcpy(dst, src + i * 4, 4);
+}
+
+static void ReferenceIA4(const uint8_t* src, size_t i, uint8_t* dst)
+{
+	uint8_t data = ReferenceNibble(src, i);
+	uint8_t grayscale = data & 0b1110;
+	grayscale = (grayscale << 4) | (grayscale << 1) | (grayscale >> 2);
+
+	dst[0] = dst[1] = dst[2] = grayscale;
+	dst[3] = (data & 0x01) ? 255 : 0;
+}
+
+static void ReferenceIA8(const uint8_t* src, size_t i, uint8_t* dst)
+{
+	uint8_t grayscale = (src[i] >> 4) & 0xF;
+	uint8_t alpha = src[i] & 0xF;
+
+	dst[0] = dst[1] = dst[2] = (grayscale << 4) | grayscale;
+	dst[3] = (alpha << 4) | alpha;
+}
+
+static void ReferenceIA16(const uint8_t* src, size_t i, uint8_t* dst)
+{
+	dst[0] = dst[1] = dst[2] = src[i * 2];
+	dst[3] = src[i * 2 + 1];
+}
+
+static void ReferenceI4(const uint8_t* src, size_t i, uint8_t* dst)
+{
+	// The original shifted an 8-bit value, so the nibble ends up in the high half only
+	uint8_t grayscale = ReferenceNibble(src, i) << 4;
+
+	dst[0] = dst[1] = dst[2] = grayscale;
+}
+
+static void ReferenceI8(const uint8_t* src, size_t i, uint8_t* dst)
+{
+	dst[0] = dst[1] = dst[2] = src[i];
+}
+
+static void ReferenceCI4(const uint8_t* src, size_t i, uint8_t* dst)
+{
+	dst[0] = ReferenceNibble(src, i);
+}
+
+static void ReferenceCI8(const uint8_t* src, size_t i, uint8_t* dst)
+{
+	dst[0] = src[i];
+}
+
+struct TextureKernelCase
+{
+	size_t srcBits;   // Per pixel
+	size_t dstBytes;  // Per pixel
+	void (*kernel)(const uint8_t* src, uint8_t* dst, size_t count);
+	void (*reference)(const uint8_t* src, size_t i, uint8_t* dst);
+};
+
+static const TextureKernelCase textureKernelCases[] = {
+	{16, 4, TextureDecode::RGBA16ToRGBA8, ReferenceRGBA16},
+	{32, 4, TextureDecode::RGBA32ToRGBA8, ReferenceRGBA32},
+	{4, 4, TextureDecode::IA4ToRGBA8, ReferenceIA4},
+	{8, 4, TextureDecode::IA8ToRGBA8, ReferenceIA8},
+	{16, 4, TextureDecode::IA16ToRGBA8, ReferenceIA16},
+	{4, 3, TextureDecode::I4ToRGB8, ReferenceI4},
+	{8, 3, TextureDecode::I8ToRGB8, ReferenceI8},
+	{4, 1, TextureDecode::CI4ToIndex, ReferenceCI4},
+	{8, 1, TextureDecode::CI8ToIndex, ReferenceCI8},
+};
+
+// Whether `count` pixels decoded by `test.kernel` from `src` match the reference
+static bool MatchesReference(const TextureKernelCase& test, const uint8_t* src, size_t count)
+{
+	static constexpr uint8_t guard = 0xCD;
+
+	// One extra pixel catches writes past the end of the span
+	std::vector<uint8_t> decoded((count + 1) * test.dstBytes, guard);
+	test.kernel(src, decoded.data(), count);
+
+	uint8_t expected[4];
+	for (size_t i = 0; i < count; i++)
+	{
+		test.reference(src, i, expected);
+		if (memcmp(decoded.data() + i * test.dstBytes, expected, test.dstBytes) != 0)
+			return false;
+	}
+
+	for (size_t i = count * test.dstBytes; i < decoded.size(); i++)
+	{
+		if (decoded[i] != guard)
+			return false;
+	}
+
+	return true;
+}
+
+void TestTextureDecode()
+{
+	for (const TextureKernelCase& test : textureKernelCases)
+	{
+		// Every possible pixel: all 16-bit values, or all bytes for the smaller formats. Texels
+		// wider than that are copies, where a byte pattern covers every value of each channel
+		std::vector<uint8_t> src;
+		if (test.srcBits == 16)
+		{
+			for (size_t value = 0; value < 0x10000; value++)
+			{
+				src.push_back(value >> 8);
+				src.push_back(value & 0xFF);
+			}
+		}
+		else
+		{
+			for (size_t i = 0; i < 1024; i++)
+				src.push_back((i * 149 + i / 256) & 0xFF);
+		}
+
+		const size_t pixelCount = src.size() * 8 / test.srcBits;
+		SELFTEST_CHECK(MatchesReference(test, src.data(), pixelCount));
+
+		// Every span length up to several vector widths, so each kernel's tail is exercised too.
+		// The 4bpp kernels start at a byte boundary, so the spans start at even pixels
+		for (size_t start : {0, 2, 6, 30})
+		{
+			for (size_t count = 1; count <= 67; count++)
+				SELFTEST_CHECK(
+					MatchesReference(test, src.data() + start * test.srcBits / 8, count));
+		}
+	}
+}
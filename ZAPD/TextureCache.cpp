@@ -0,0 +1,147 @@
+#include "TextureCache.h"
+
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+struct TextureCacheKey
+{
+	TextureType format;
+	uint32_t width;
+	uint32_t height;
+	uint32_t hash;
+
+	bool operator<(const TextureCacheKey& other) const
+	{
+		return std::tie(format, width, height, hash) <
+		       std::tie(other.format, other.width, other.height, other.hash);
+	}
+};
+
+static std::atomic<bool> cacheEnabled{false};
+static std::mutex cacheMutex;
+// Entries are never removed, so pointers to them stay valid until exit. A key holds several
+// entries in the unlikely case of a hash collision
+static std::map<TextureCacheKey, std::vector<std::unique_ptr<TextureCacheEntry>>> cacheEntries;
+
+static std::atomic<uint64_t> decodeHitCount{0};
+static std::atomic<uint64_t> decodeHitBytes{0};
+static std::atomic<uint64_t> exportHitCount{0};
+static std::atomic<uint64_t> exportHitBytes{0};
+
+// Must be called with `cacheMutex` held
+static TextureCacheEntry* FindLocked(const TextureCacheKey& key, const uint8_t* data, size_t size)
+{
+	auto bucket = cacheEntries.find(key);
+	if (bucket == cacheEntries.end())
+		return nullptr;
+
+	for (const auto& entry : bucket->second)
+	{
+		if (entry->rawData.size() == size && memcmp(entry->rawData.data(), data, size) == 0)
+			return entry.get();
+	}
+
+	return nullptr;
+}
+
+void TextureCache::Enable()
+{
+	cacheEnabled.store(true, std::memory_order_relaxed);
+}
+
+bool TextureCache::IsEnabled()
+{
+	return cacheEnabled.load(std::memory_order_relaxed);
+}
+
+TextureCacheEntry* TextureCache::Find(TextureType format, uint32_t width, uint32_t height,
+                                      uint32_t hash, const uint8_t* data, size_t size)
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	TextureCacheEntry* entry = FindLocked({format, width, height, hash}, data, size);
+
+	if (entry != nullptr)
+	{
+		decodeHitCount.fetch_add(1, std::memory_order_relaxed);
+		decodeHitBytes.fetch_add(size, std::memory_order_relaxed);
+	}
+
+	return entry;
+}
+
+TextureCacheEntry* TextureCache::Insert(const std::string& ownerFile, uint32_t ownerOffset,
+                                        bool dWordAligned, TextureType format, uint32_t width,
+                                        uint32_t height, uint32_t hash, const uint8_t* data,
+                                        size_t size, const ImageBackend& image)
+{
+	TextureCacheKey key = {format, width, height, hash};
+
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	TextureCacheEntry* entry = FindLocked(key, data, size);
+	if (entry != nullptr)
+		return entry;
+
+	auto newEntry = std::make_unique<TextureCacheEntry>();
+	newEntry->ownerFile = ownerFile;
+	newEntry->ownerOffset = ownerOffset;
+	newEntry->ownerDWordAligned = dWordAligned;
+	newEntry->rawData.assign(data, data + size);
+	newEntry->image = image;
+
+	entry = newEntry.get();
+	cacheEntries[key].push_back(std::move(newEntry));
+	return entry;
+}
+
+void TextureCache::SetOwnerDeclaration(TextureCacheEntry* entry, const std::string& includePath,
+                                       const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	entry->ownerIncludePath = includePath;
+	entry->ownerName = name;
+}
+
+std::string TextureCache::GetOwnerIncludePath(const TextureCacheEntry* entry)
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	return entry->ownerIncludePath;
+}
+
+std::string TextureCache::GetOwnerName(const TextureCacheEntry* entry)
+{
+	std::lock_guard<std::mutex> lock(cacheMutex);
+	return entry->ownerName;
+}
+
+void TextureCache::RecordExportHit(size_t size)
+{
+	exportHitCount.fetch_add(1, std::memory_order_relaxed);
+	exportHitBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void TextureCache::PrintReport()
+{
+	if (!IsEnabled())
+		return;
+
+	size_t uniqueCount = 0;
+	{
+		std::lock_guard<std::mutex> lock(cacheMutex);
+		for (const auto& bucket : cacheEntries)
+			uniqueCount += bucket.second.size();
+	}
+
+	printf("Texture dedup: %zu unique textures\n", uniqueCount);
+	printf("\tDecode hits: %10" PRIu64 " (%" PRIu64 " KB not decoded)\n",
+	       decodeHitCount.load(std::memory_order_relaxed),
+	       decodeHitBytes.load(std::memory_order_relaxed) / 1024);
+	printf("\tExport hits: %10" PRIu64 " (%" PRIu64 " KB not exported)\n",
+	       exportHitCount.load(std::memory_order_relaxed),
+	       exportHitBytes.load(std::memory_order_relaxed) / 1024);
+}
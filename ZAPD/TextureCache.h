@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ImageBackend.h"
+
+enum class TextureType;
+
+/**
+ * Process-wide cache of decoded textures, keyed by format, dimensions and contents.
+ * The first texture seen with some contents owns the entry. Later textures with identical raw
+ * data copy its decoded image instead of decoding again, and can reference its exported file
+ * instead of writing their own.
+ * The owner is identified by its file and offset rather than by address, as files are freed after
+ * each job and a new texture may reuse the owner's memory.
+ */
+struct TextureCacheEntry
+{
+	std::string ownerFile;
+	uint32_t ownerOffset;
+	bool ownerDWordAligned;
+	std::vector<uint8_t> rawData;
+	ImageBackend image;  // Decoded, before any TLUT is applied
+	std::string ownerIncludePath;  // Set once the owner has been declared, like `ownerName`
+	std::string ownerName;
+};
+
+class TextureCache
+{
+public:
+	static void Enable();
+	static bool IsEnabled();
+
+	// Returns the entry whose raw data matches `data`, or nullptr if there is none
+	static TextureCacheEntry* Find(TextureType format, uint32_t width, uint32_t height,
+	                               uint32_t hash, const uint8_t* data, size_t size);
+
+	/**
+	 * Adds `image` as the decoded contents of `data`, owned by the texture at `ownerOffset` in
+	 * `ownerFile`. If another thread inserted the same contents first, its entry is returned
+	 * instead.
+	 */
+	static TextureCacheEntry* Insert(const std::string& ownerFile, uint32_t ownerOffset,
+	                                 bool dWordAligned, TextureType format, uint32_t width,
+	                                 uint32_t height, uint32_t hash, const uint8_t* data,
+	                                 size_t size, const ImageBackend& image);
+
+	static void SetOwnerDeclaration(TextureCacheEntry* entry, const std::string& includePath,
+	                                const std::string& name);
+	static std::string GetOwnerIncludePath(const TextureCacheEntry* entry);
+	static std::string GetOwnerName(const TextureCacheEntry* entry);
+
+	static void RecordExportHit(size_t size);
+	static void PrintReport();
+};
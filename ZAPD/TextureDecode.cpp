@@ -0,0 +1,219 @@
+#include "TextureDecode.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define TEXTURE_DECODE_SSE2 1
+#endif
+
+static inline uint8_t Expand5To8(uint8_t value)
+{
+	return (value << 3) | (value >> 2);
+}
+
+static inline void DecodeIA4Pixel(uint8_t data, uint8_t* dst)
+{
+	uint8_t grayscale = data & 0b1110;
+	grayscale = (grayscale << 4) | (grayscale << 1) | (grayscale >> 2);
+
+	dst[0] = grayscale;
+	dst[1] = grayscale;
+	dst[2] = grayscale;
+	dst[3] = (data & 0x01) ? 255 : 0;
+}
+
+static inline void DecodeI4Pixel(uint8_t data, uint8_t* dst)
+{
+	uint8_t grayscale = data << 4;
+
+	dst[0] = grayscale;
+	dst[1] = grayscale;
+	dst[2] = grayscale;
+}
+
+void TextureDecode::RGBA16ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(TEXTURE_DECODE_SSE2)
+	const __m128i mask5 = _mm_set1_epi16(0x1F);
+	const __m128i maskAlpha = _mm_set1_epi16(0x01);
+	const __m128i maskLowByte = _mm_set1_epi16(0xFF);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+
+		__m128i r = _mm_srli_epi16(v, 11);
+		__m128i g = _mm_and_si128(_mm_srli_epi16(v, 6), mask5);
+		__m128i b = _mm_and_si128(_mm_srli_epi16(v, 1), mask5);
+		// 0 - 1 is 0xFFFF, keep the low byte
+		__m128i a = _mm_and_si128(_mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(v, maskAlpha)),
+		                          maskLowByte);
+
+		r = _mm_or_si128(_mm_slli_epi16(r, 3), _mm_srli_epi16(r, 2));
+		g = _mm_or_si128(_mm_slli_epi16(g, 3), _mm_srli_epi16(g, 2));
+		b = _mm_or_si128(_mm_slli_epi16(b, 3), _mm_srli_epi16(b, 2));
+
+		__m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+		__m128i ba = _mm_or_si128(b, _mm_slli_epi16(a, 8));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_unpacklo_epi16(rg, ba));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 16), _mm_unpackhi_epi16(rg, ba));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		uint16_t data = (src[i * 2] << 8) | src[i * 2 + 1];
+		uint8_t* pixel = dst + i * 4;
+
+		pixel[0] = Expand5To8((data & 0xF800) >> 11);
+		pixel[1] = Expand5To8((data & 0x07C0) >> 6);
+		pixel[2] = Expand5To8((data & 0x003E) >> 1);
+		pixel[3] = (data & 0x01) * 255;
+	}
+}
+
+void TextureDecode::RGBA32ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count)
+{
+	memcpy(dst, src, count * 4);
+}
+
+void TextureDecode::IA4ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		uint8_t data = src[i / 2];
+
+		DecodeIA4Pixel(data >> 4, dst + i * 4);
+		DecodeIA4Pixel(data & 0x0F, dst + i * 4 + 4);
+	}
+
+	if (i < count)
+		DecodeIA4Pixel(src[i / 2] >> 4, dst + i * 4);
+}
+
+void TextureDecode::IA8ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(TEXTURE_DECODE_SSE2)
+	const __m128i maskHigh = _mm_set1_epi8(static_cast<char>(0xF0));
+	const __m128i maskLow = _mm_set1_epi8(0x0F);
+
+	for (; i + 16 <= count; i += 16)
+	{
+		__m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+		// Replicate each nibble into both halves of its byte. The masks keep the 16-bit shifts
+		// from leaking bits across bytes
+		__m128i high = _mm_and_si128(p, maskHigh);
+		__m128i low = _mm_and_si128(p, maskLow);
+		__m128i g = _mm_or_si128(high, _mm_srli_epi16(high, 4));
+		__m128i a = _mm_or_si128(low, _mm_slli_epi16(low, 4));
+
+		__m128i gg = _mm_unpacklo_epi8(g, g);
+		__m128i ga = _mm_unpacklo_epi8(g, a);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_unpacklo_epi16(gg, ga));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 16), _mm_unpackhi_epi16(gg, ga));
+
+		gg = _mm_unpackhi_epi8(g, g);
+		ga = _mm_unpackhi_epi8(g, a);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 32), _mm_unpacklo_epi16(gg, ga));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 48), _mm_unpackhi_epi16(gg, ga));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		uint8_t grayscale = src[i] >> 4;
+		uint8_t alpha = src[i] & 0x0F;
+		uint8_t* pixel = dst + i * 4;
+
+		grayscale = (grayscale << 4) | grayscale;
+		pixel[0] = grayscale;
+		pixel[1] = grayscale;
+		pixel[2] = grayscale;
+		pixel[3] = (alpha << 4) | alpha;
+	}
+}
+
+void TextureDecode::IA16ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count)
+{
+	size_t i = 0;
+
+#if defined(TEXTURE_DECODE_SSE2)
+	const __m128i maskLowByte = _mm_set1_epi16(0xFF);
+
+	for (; i + 8 <= count; i += 8)
+	{
+		// Each 16-bit lane holds grayscale in its low byte and alpha in its high byte
+		__m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 2));
+		__m128i g = _mm_and_si128(v, maskLowByte);
+		__m128i gg = _mm_or_si128(g, _mm_slli_epi16(g, 8));
+
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_unpacklo_epi16(gg, v));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4 + 16), _mm_unpackhi_epi16(gg, v));
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		uint8_t* pixel = dst + i * 4;
+
+		pixel[0] = src[i * 2];
+		pixel[1] = src[i * 2];
+		pixel[2] = src[i * 2];
+		pixel[3] = src[i * 2 + 1];
+	}
+}
+
+void TextureDecode::I4ToRGB8(const uint8_t* src, uint8_t* dst, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		uint8_t data = src[i / 2];
+
+		DecodeI4Pixel(data >> 4, dst + i * 3);
+		DecodeI4Pixel(data & 0x0F, dst + i * 3 + 3);
+	}
+
+	if (i < count)
+		DecodeI4Pixel(src[i / 2] >> 4, dst + i * 3);
+}
+
+void TextureDecode::I8ToRGB8(const uint8_t* src, uint8_t* dst, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		dst[i * 3 + 0] = src[i];
+		dst[i * 3 + 1] = src[i];
+		dst[i * 3 + 2] = src[i];
+	}
+}
+
+void TextureDecode::CI4ToIndex(const uint8_t* src, uint8_t* dst, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 2 <= count; i += 2)
+	{
+		dst[i] = src[i / 2] >> 4;
+		dst[i + 1] = src[i / 2] & 0x0F;
+	}
+
+	if (i < count)
+		dst[i] = src[i / 2] >> 4;
+}
+
+void TextureDecode::CI8ToIndex(const uint8_t* src, uint8_t* dst, size_t count)
+{
+	memcpy(dst, src, count);
+}
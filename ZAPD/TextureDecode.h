@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Batch decoders from the N64 texture formats to 8-bit PNG pixels.
+ * Each kernel decodes a span of `count` pixels, usually a full row, reading the source once and
+ * writing the destination sequentially. Uses SSE2 when available, with a scalar fallback.
+ * The 4bpp kernels start at the high nibble of `src[0]`.
+ */
+class TextureDecode
+{
+public:
+	// To RGBA, 4 bytes per pixel
+	static void RGBA16ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count);
+	static void RGBA32ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count);
+	static void IA4ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count);
+	static void IA8ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count);
+	static void IA16ToRGBA8(const uint8_t* src, uint8_t* dst, size_t count);
+
+	// To RGB, 3 bytes per pixel
+	static void I4ToRGB8(const uint8_t* src, uint8_t* dst, size_t count);
+	static void I8ToRGB8(const uint8_t* src, uint8_t* dst, size_t count);
+
+	// To palette indices, 1 byte per pixel
+	static void CI4ToIndex(const uint8_t* src, uint8_t* dst, size_t count);
+	static void CI8ToIndex(const uint8_t* src, uint8_t* dst, size_t count);
+};
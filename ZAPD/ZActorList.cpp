@@ -8,9 +8,13 @@
 
 REGISTER_ZFILENODE(ActorList, ZActorList);
 
+static const ResourceAttributeSchema actorListAttributes(&ZResource::commonAttributes, {
+	{"Count", true},
+});
+
 ZActorList::ZActorList(ZFile* nParent) : ZResource(nParent)
 {
-	RegisterRequiredAttribute("Count");
+	attributeSchema = &actorListAttributes;
 }
 
 void ZActorList::ExtractFromBinary(uint32_t nRawDataIndex, uint8_t nNumActors)
@@ -29,7 +33,7 @@ void ZActorList::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	numActors = StringHelper::StrToL(registeredAttributes.at("Count").value);
+	numActors = StringHelper::StrToL(GetAttribute("Count").value);
 
 	if (numActors < 1)
 	{
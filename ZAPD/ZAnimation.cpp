@@ -2,7 +2,9 @@
 
 #include <utility>
 
+#include "BulkDecode.h"
 #include "Globals.h"
+#include "SourceEmitter.h"
 #include "Utils/BitConverter.h"
 #include <Utils/DiskFile.h>
 #include "Utils/StringHelper.h"
@@ -76,25 +78,18 @@ void ZNormalAnimation::ParseRawData()
 	rotationValuesOffset = Seg2Filespace(rotationValuesSeg, parent->baseAddress);
 	rotationIndicesOffset = Seg2Filespace(rotationIndicesSeg, parent->baseAddress);
 
-	uint32_t currentPtr = rotationValuesOffset;
-
 	// Read the Rotation Values
-	for (uint32_t i = 0; i < ((rotationIndicesOffset - rotationValuesOffset) / 2); i++)
-	{
-		rotationValues.push_back(BitConverter::ToInt16BE(data, currentPtr));
-		currentPtr += 2;
-	}
-
-	currentPtr = rotationIndicesOffset;
+	uint32_t numRotationValues = (rotationIndicesOffset - rotationValuesOffset) / 2;
+	rotationValues = BulkDecode::ReadU16Array(data, rotationValuesOffset, numRotationValues);
 
 	// Read the Rotation Indices
-	for (uint32_t i = 0; i < ((rawDataIndex - rotationIndicesOffset) / 6); i++)
-	{
-		rotationIndices.push_back(RotationIndex(BitConverter::ToInt16BE(data, currentPtr),
-		                                        BitConverter::ToInt16BE(data, currentPtr + 2),
-		                                        BitConverter::ToInt16BE(data, currentPtr + 4)));
-		currentPtr += 6;
-	}
+	uint32_t numRotationIndices = (rawDataIndex - rotationIndicesOffset) / 6;
+	std::vector<uint16_t> indices =
+		BulkDecode::ReadU16Array(data, rotationIndicesOffset, numRotationIndices * 3);
+
+	rotationIndices.reserve(numRotationIndices);
+	for (uint32_t i = 0; i < numRotationIndices; i++)
+		rotationIndices.emplace_back(indices[i * 3], indices[i * 3 + 1], indices[i * 3 + 2]);
 }
 
 void ZNormalAnimation::DeclareReferences(const std::string& prefix)
@@ -114,13 +109,19 @@ void ZNormalAnimation::DeclareReferences(const std::string& prefix)
 
 	if (!Globals::Instance->otrMode)
 	{
-		for (size_t i = 0; i < rotationValues.size(); i++)
-		{
-			valuesStr += StringHelper::Sprintf("0x%04X, ", rotationValues[i]);
+		// "0x%04X, " plus a line break
+		SourceEmitter::Append(valuesStr, rotationValues.size() * 13, [&](char* dst) {
+			for (size_t i = 0; i < rotationValues.size(); i++)
+			{
+				dst = SourceEmitter::Text(dst, "0x");
+				dst = SourceEmitter::Hex(dst, rotationValues[i], 4);
+				dst = SourceEmitter::Text(dst, ", ");
 
-			if ((i - offset + 1) % lineLength == 0)
-				valuesStr += "\n    ";
-		}
+				if ((i - offset + 1) % lineLength == 0)
+					dst = SourceEmitter::Text(dst, "\n    ");
+			}
+			return dst;
+		});
 	}
 
 	parent->AddDeclarationArray(rotationValuesOffset, DeclarationAlignment::Align4,
@@ -130,14 +131,23 @@ void ZNormalAnimation::DeclareReferences(const std::string& prefix)
 
 	if (!Globals::Instance->otrMode)
 	{
-		for (size_t i = 0; i < rotationIndices.size(); i++)
-		{
-			indicesStr += StringHelper::Sprintf("    { 0x%04X, 0x%04X, 0x%04X },", rotationIndices[i].x,
-				                            rotationIndices[i].y, rotationIndices[i].z);
-
-			if (i != (rotationIndices.size() - 1))
-				indicesStr += "\n";
-		}
+		// "    { 0x%04X, 0x%04X, 0x%04X }," plus a line feed
+		SourceEmitter::Append(indicesStr, rotationIndices.size() * 32, [&](char* dst) {
+			for (size_t i = 0; i < rotationIndices.size(); i++)
+			{
+				dst = SourceEmitter::Text(dst, "    { 0x");
+				dst = SourceEmitter::Hex(dst, rotationIndices[i].x, 4);
+				dst = SourceEmitter::Text(dst, ", 0x");
+				dst = SourceEmitter::Hex(dst, rotationIndices[i].y, 4);
+				dst = SourceEmitter::Text(dst, ", 0x");
+				dst = SourceEmitter::Hex(dst, rotationIndices[i].z, 4);
+				dst = SourceEmitter::Text(dst, " },");
+
+				if (i != (rotationIndices.size() - 1))
+					*dst++ = '\n';
+			}
+			return dst;
+		});
 	}
 
 	parent->AddDeclarationArray(rotationIndicesOffset, DeclarationAlignment::Align4,
@@ -233,16 +243,20 @@ std::string CurveInterpKnot::GetSourceTypeName()
 	return "CurveInterpKnot";
 }
 
+static const ResourceAttributeSchema curveAnimationAttributes(&ZResource::commonAttributes, {
+	{"SkelOffset", false},
+});
+
 ZCurveAnimation::ZCurveAnimation(ZFile* nParent) : ZAnimation(nParent)
 {
-	RegisterOptionalAttribute("SkelOffset");
+	attributeSchema = &curveAnimationAttributes;
 }
 
 void ZCurveAnimation::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZAnimation::ParseXML(reader);
 
-	std::string skelOffsetXml = registeredAttributes.at("SkelOffset").value;
+	std::string skelOffsetXml = GetAttribute("SkelOffset").value;
 	if (skelOffsetXml == "")
 	{
 		HANDLE_ERROR_RESOURCE(WarningType::MissingAttribute, parent, this, rawDataIndex,
@@ -312,9 +326,11 @@ void ZCurveAnimation::DeclareReferences(const std::string& prefix)
 		uint16_t arrayItemCnt = refIndexArr.size();
 
 		size_t i = 0;
-		for (auto& child : refIndexArr)
+		if (!Globals::Instance->binaryOnly)
 		{
-			entryStr += StringHelper::Sprintf("0x%02X, %s", child, (i++ % 8 == 7) ? "\n    " : "");
+			for (auto& child : refIndexArr)
+				entryStr +=
+					StringHelper::Sprintf("0x%02X, %s", child, (i++ % 8 == 7) ? "\n    " : "");
 		}
 
 		Declaration* decl = parent->GetDeclaration(refIndexOffset);
@@ -341,10 +357,11 @@ void ZCurveAnimation::DeclareReferences(const std::string& prefix)
 		uint16_t arrayItemCnt = transformDataArr.size();
 
 		size_t i = 0;
-		for (auto& child : transformDataArr)
+		if (!Globals::Instance->binaryOnly)
 		{
-			entryStr += StringHelper::Sprintf("    { %s },%s", child.GetBody(prefix).c_str(),
-			                                  (++i < arrayItemCnt) ? "\n" : "");
+			for (auto& child : transformDataArr)
+				entryStr += StringHelper::Sprintf("    { %s },%s", child.GetBody(prefix).c_str(),
+				                                  (++i < arrayItemCnt) ? "\n" : "");
 		}
 
 		Declaration* decl = parent->GetDeclaration(transformDataOffset);
@@ -371,9 +388,11 @@ void ZCurveAnimation::DeclareReferences(const std::string& prefix)
 		uint16_t arrayItemCnt = copyValuesArr.size();
 
 		size_t i = 0;
-		for (auto& child : copyValuesArr)
+		if (!Globals::Instance->binaryOnly)
 		{
-			entryStr += StringHelper::Sprintf("% 6i, %s", child, (i++ % 8 == 7) ? "\n    " : "");
+			for (auto& child : copyValuesArr)
+				entryStr +=
+					StringHelper::Sprintf("% 6i, %s", child, (i++ % 8 == 7) ? "\n    " : "");
 		}
 
 		Declaration* decl = parent->GetDeclaration(copyValuesOffset);
@@ -472,14 +491,24 @@ void ZLegacyAnimation::DeclareReferences(const std::string& prefix)
 		uint32_t frameDataOffset = Seg2Filespace(frameData, parent->baseAddress);
 		if (GETSEGNUM(frameData) == parent->segment && !parent->HasDeclaration(frameDataOffset))
 		{
-			std::string frameDataBody = "\t";
+			std::string frameDataBody;
 
-			for (size_t i = 0; i < frameDataArray.size(); i++)
+			// "0x%04X, " plus a line break
+			if (!Globals::Instance->binaryOnly)
 			{
-				frameDataBody += StringHelper::Sprintf("0x%04X, ", frameDataArray[i]);
-
-				if (i % 8 == 7 && i + 1 < frameDataArray.size())
-					frameDataBody += "\n\t";
+				frameDataBody = "\t";
+				SourceEmitter::Append(frameDataBody, frameDataArray.size() * 10, [&](char* dst) {
+					for (size_t i = 0; i < frameDataArray.size(); i++)
+					{
+						dst = SourceEmitter::Text(dst, "0x");
+						dst = SourceEmitter::Hex(dst, frameDataArray[i], 4);
+						dst = SourceEmitter::Text(dst, ", ");
+
+						if (i % 8 == 7 && i + 1 < frameDataArray.size())
+							dst = SourceEmitter::Text(dst, "\n\t");
+					}
+					return dst;
+				});
 			}
 
 			std::string frameDataName = StringHelper::Sprintf("%sFrameData", varPrefix.c_str());
@@ -497,7 +526,7 @@ void ZLegacyAnimation::DeclareReferences(const std::string& prefix)
 			const auto res = jointKeyArray.at(0);
 			std::string jointKeyBody;
 
-			for (size_t i = 0; i < jointKeyArray.size(); i++)
+			for (size_t i = 0; i < jointKeyArray.size() && !Globals::Instance->binaryOnly; i++)
 			{
 				jointKeyBody += StringHelper::Sprintf("\t{ %s },",
 				                                      jointKeyArray[i].GetBodySourceCode().c_str());
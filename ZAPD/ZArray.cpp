@@ -9,11 +9,15 @@
 
 REGISTER_ZFILENODE(Array, ZArray);
 
+static const ResourceAttributeSchema arrayAttributes(&ZResource::commonAttributes, {
+	{"Count", true},
+});
+
 ZArray::ZArray(ZFile* nParent) : ZResource(nParent)
 {
 	canHaveInner = true;
 	genOTRDef = true;
-	RegisterRequiredAttribute("Count");
+	attributeSchema = &arrayAttributes;
 }
 
 ZArray::~ZArray()
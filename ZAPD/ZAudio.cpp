@@ -1,5 +1,16 @@
 #include "ZAudio.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <ctpl_stl.h>
+#include <future>
+#include <thread>
+#include <tuple>
+
+#include "AdpcmDecode.h"
+#include "BulkDecode.h"
+#include "CRC32.h"
 #include "Globals.h"
 #include "Utils/BitConverter.h"
 #include <Utils/DiskFile.h>
@@ -9,12 +20,19 @@
 
 REGISTER_ZFILENODE(Audio, ZAudio);
 
+static std::atomic<uint64_t> sampleDedupCount{0};
+static std::atomic<uint64_t> sampleDedupBytes{0};
+
+static const ResourceAttributeSchema audioAttributes(&ZResource::commonAttributes, {
+	{"SoundFontTableOffset", true},
+	{"SequenceTableOffset", true},
+	{"SampleBankTableOffset", true},
+	{"SequenceFontTableOffset", true},
+});
+
 ZAudio::ZAudio(ZFile* nParent) : ZResource(nParent)
 {
-	RegisterRequiredAttribute("SoundFontTableOffset");
-	RegisterRequiredAttribute("SequenceTableOffset");
-	RegisterRequiredAttribute("SampleBankTableOffset");
-	RegisterRequiredAttribute("SequenceFontTableOffset");
+	attributeSchema = &audioAttributes;
 }
 
 void ZAudio::ParseXML(tinyxml2::XMLElement* reader)
@@ -82,12 +100,11 @@ void ZAudio::ParseXML(tinyxml2::XMLElement* reader)
 
 void ZAudio::DecodeADPCMSample(SampleEntry* sample)
 {
-	int16_t buffer[1024 * 128];
-
-	int16_t* out = &buffer[0];
+	sample->pcm = AdpcmDecode::DecodeSample(*sample);
 }
 
-std::vector<AdsrEnvelope*> ZAudio::ParseEnvelopeData(std::vector<uint8_t> audioBank, std::vector<uint8_t> audioTable, int envelopeOffset, int baseOffset)
+std::vector<AdsrEnvelope*> ZAudio::ParseEnvelopeData(const std::vector<uint8_t>& audioBank,
+                                                     int envelopeOffset, int baseOffset)
 {
 	std::vector<AdsrEnvelope*> result;
 
@@ -109,30 +126,31 @@ std::vector<AdsrEnvelope*> ZAudio::ParseEnvelopeData(std::vector<uint8_t> audioB
 	return result;
 }
 
-SoundFontEntry* ZAudio::ParseSoundFontEntry(std::vector<uint8_t> audioBank,
-                                            std::vector<uint8_t> audioTable,
-                                            AudioTableEntry audioSampleBankEntry, int bankIndex,
-                                            int soundFontOffset,
-                                            int baseOffset)
+SoundFontEntry* ZAudio::ParseSoundFontEntry(const std::vector<uint8_t>& audioBank,
+                                            const std::vector<uint8_t>& audioTable,
+                                            const AudioTableEntry& audioSampleBankEntry,
+                                            int bankIndex, int soundFontOffset, int baseOffset,
+                                            std::map<uint32_t, SampleEntry*>& fontSamples)
 {
 	SoundFontEntry* soundFont = new SoundFontEntry();
 	soundFont->sampleEntry = ParseSampleEntry(
 		audioBank, audioTable, audioSampleBankEntry, bankIndex,
-		BitConverter::ToInt32BE(audioBank, soundFontOffset + 0) + baseOffset, baseOffset);
+		BitConverter::ToInt32BE(audioBank, soundFontOffset + 0) + baseOffset, baseOffset,
+		fontSamples);
 	soundFont->tuning = BitConverter::ToFloatBE(audioBank, soundFontOffset + 4);
 
 	return soundFont;
 }
 
-SampleEntry* ZAudio::ParseSampleEntry(std::vector<uint8_t> audioBank,
-                                      std::vector<uint8_t> audioTable,
-                                      AudioTableEntry audioSampleBankEntry, int bankIndex,
-                                      int sampleOffset,
-                                      int baseOffset)
+SampleEntry* ZAudio::ParseSampleEntry(const std::vector<uint8_t>& audioBank,
+                                      const std::vector<uint8_t>& audioTable,
+                                      const AudioTableEntry& audioSampleBankEntry, int bankIndex,
+                                      int sampleOffset, int baseOffset,
+                                      std::map<uint32_t, SampleEntry*>& fontSamples)
 {
 	int sampleDataOffset = BitConverter::ToInt32BE(audioBank, sampleOffset + 4) + audioSampleBankEntry.ptr;
 
-	if (samples.find(sampleOffset) == samples.end())
+	if (fontSamples.find(sampleOffset) == fontSamples.end())
 	{
 		SampleEntry* sample = new SampleEntry();
 
@@ -142,10 +160,10 @@ SampleEntry* ZAudio::ParseSampleEntry(std::vector<uint8_t> audioBank,
 		int loopOffset = BitConverter::ToInt32BE(audioBank, sampleOffset + 8) + baseOffset;
 		int bookOffset = BitConverter::ToInt32BE(audioBank, sampleOffset + 12) + baseOffset;
 
-		char* sampleData = (char*)malloc(sampleSize);
-		memcpy(sampleData, audioTable.data() + sampleDataOffset, sampleSize);
-		sample->data = std::vector<uint8_t>(sampleSize);
-		memcpy(sample->data.data(), sampleData, sampleSize);
+		BulkDecode::CheckBounds(audioTable, sampleDataOffset, sampleSize,
+		                        "ZAudio::ParseSampleEntry");
+		sample->data.assign(audioTable.begin() + sampleDataOffset,
+		                    audioTable.begin() + sampleDataOffset + sampleSize);
 
 		uint32_t origField = (BitConverter::ToUInt32BE(audioBank, sampleOffset + 0));
 		sample->codec = (origField >> 28) & 0x0F;
@@ -158,22 +176,14 @@ SampleEntry* ZAudio::ParseSampleEntry(std::vector<uint8_t> audioBank,
 		sample->loop.count = BitConverter::ToInt32BE(audioBank, loopOffset + 8);
 
 		if (sample->loop.count != 0)
-		{
-			for (int i = 0; i < 16; i++)
-			{
-				int16_t state = BitConverter::ToInt16BE(audioBank, loopOffset + 16 + (i * 2));
-				sample->loop.states.push_back(state);
-			}
-		}
+			sample->loop.states = BulkDecode::ReadS16Array(audioBank, loopOffset + 16, 16);
 
 		sample->book.order = BitConverter::ToInt32BE(audioBank, bookOffset + 0);
 		sample->book.npredictors = BitConverter::ToInt32BE(audioBank, bookOffset + 4);
 
-		for (int i = 0; i < sample->book.npredictors * sample->book.order * 8; i++)
-		{
-			sample->book.books.push_back(
-				BitConverter::ToInt16BE(audioBank, bookOffset + 8 + (i * 2)));
-		}
+		int bookSize = sample->book.npredictors * sample->book.order * 8;
+		if (bookSize > 0)
+			sample->book.books = BulkDecode::ReadS16Array(audioBank, bookOffset + 8, bookSize);
 
 		sample->sampleDataOffset = sampleDataOffset;
 
@@ -182,17 +192,18 @@ SampleEntry* ZAudio::ParseSampleEntry(std::vector<uint8_t> audioBank,
 
 		sample->fileName = StringHelper::Sprintf("audio/samples/sample_%08X", sampleOffset);
 
-		samples[sampleOffset] = sample;
+		fontSamples[sampleOffset] = sample;
 
 		return sample;
 	}
 	else
 	{
-		return samples[sampleOffset];
+		return fontSamples[sampleOffset];
 	}
 }
 
-std::vector<AudioTableEntry> ZAudio::ParseAudioTable(std::vector<uint8_t> codeData, int baseOffset)
+std::vector<AudioTableEntry> ZAudio::ParseAudioTable(const std::vector<uint8_t>& codeData,
+                                                     int baseOffset)
 {
 	std::vector<AudioTableEntry> entries;
 
@@ -221,9 +232,10 @@ std::vector<AudioTableEntry> ZAudio::ParseAudioTable(std::vector<uint8_t> codeDa
 	return entries;
 }
 
-void ZAudio::ParseSoundFont(std::vector<uint8_t> codeData, std::vector<uint8_t> audioTable,
-                            std::vector<AudioTableEntry> audioSampleBank,
-                            AudioTableEntry& entry)
+void ZAudio::ParseSoundFont(const std::vector<uint8_t>& audioBank,
+                            const std::vector<uint8_t>& audioTable,
+                            const std::vector<AudioTableEntry>& audioSampleBank,
+                            AudioTableEntry& entry, std::map<uint32_t, SampleEntry*>& fontSamples)
 {
 	int ptr = entry.ptr;
 	int size = entry.size;
@@ -233,25 +245,26 @@ void ZAudio::ParseSoundFont(std::vector<uint8_t> codeData, std::vector<uint8_t>
 	int numDrums = entry.data2 & 0xFF;
 	int numSfx = entry.data3;
 
-	int currentOffset = BitConverter::ToInt32BE(codeData, ptr) + ptr;
+	int currentOffset = BitConverter::ToInt32BE(audioBank, ptr) + ptr;
 	for (int i = 0; i < numDrums; i++)
 	{
 		DrumEntry drum;
 
-		int samplePtr = BitConverter::ToInt32BE(codeData, currentOffset);
+		int samplePtr = BitConverter::ToInt32BE(audioBank, currentOffset);
 
 		if (samplePtr != 0)
 		{
 			samplePtr += ptr;
 
-			drum.sample = ParseSampleEntry(codeData, audioTable, audioSampleBank[sampleBankId1], sampleBankId1,
-			                               BitConverter::ToInt32BE(codeData, samplePtr + 4) + ptr, ptr);
+			drum.sample = ParseSampleEntry(audioBank, audioTable, audioSampleBank[sampleBankId1], sampleBankId1,
+			                               BitConverter::ToInt32BE(audioBank, samplePtr + 4) + ptr, ptr,
+			                               fontSamples);
 
-			drum.releaseRate = codeData[samplePtr + 0];
-			drum.pan = codeData[samplePtr + 1];
-			drum.loaded = codeData[samplePtr + 2];
-			drum.tuning = BitConverter::ToFloatBE(codeData, samplePtr + 8);
-			drum.env = ParseEnvelopeData(codeData, audioTable, BitConverter::ToInt32BE(codeData, samplePtr + 12) + ptr, ptr);
+			drum.releaseRate = audioBank[samplePtr + 0];
+			drum.pan = audioBank[samplePtr + 1];
+			drum.loaded = audioBank[samplePtr + 2];
+			drum.tuning = BitConverter::ToFloatBE(audioBank, samplePtr + 8);
+			drum.env = ParseEnvelopeData(audioBank, BitConverter::ToInt32BE(audioBank, samplePtr + 12) + ptr, ptr);
 		}
 
 		entry.drums.push_back(drum);
@@ -259,12 +272,12 @@ void ZAudio::ParseSoundFont(std::vector<uint8_t> codeData, std::vector<uint8_t>
 		currentOffset += 4;
 	}
 
-	currentOffset = BitConverter::ToInt32BE(codeData, ptr + 4) + ptr;
+	currentOffset = BitConverter::ToInt32BE(audioBank, ptr + 4) + ptr;
 	for (int i = 0; i < numSfx; i++)
 	{
 		SoundFontEntry* sfx;
-		sfx = ParseSoundFontEntry(codeData, audioTable, audioSampleBank[sampleBankId1], sampleBankId1,
-		                          currentOffset, ptr);
+		sfx = ParseSoundFontEntry(audioBank, audioTable, audioSampleBank[sampleBankId1], sampleBankId1,
+		                          currentOffset, ptr, fontSamples);
 		entry.soundEffects.push_back(sfx);
 
 		currentOffset += 8;
@@ -274,7 +287,7 @@ void ZAudio::ParseSoundFont(std::vector<uint8_t> codeData, std::vector<uint8_t>
 	{
 		InstrumentEntry instrument;
 
-		currentOffset = BitConverter::ToInt32BE(codeData, ptr + 8 + (i * 4));
+		currentOffset = BitConverter::ToInt32BE(audioBank, ptr + 8 + (i * 4));
 
 		instrument.isValidInstrument = currentOffset != 0;
 
@@ -282,30 +295,69 @@ void ZAudio::ParseSoundFont(std::vector<uint8_t> codeData, std::vector<uint8_t>
 		{
 			currentOffset += ptr;
 
-			instrument.loaded = codeData[currentOffset + 0];
-			instrument.normalRangeLo = codeData[currentOffset + 1];
-			instrument.normalRangeHi = codeData[currentOffset + 2];
-			instrument.releaseRate = codeData[currentOffset + 3];
-			instrument.env = ParseEnvelopeData(codeData, audioTable, BitConverter::ToInt32BE(codeData, currentOffset + 4) + ptr, ptr);
+			instrument.loaded = audioBank[currentOffset + 0];
+			instrument.normalRangeLo = audioBank[currentOffset + 1];
+			instrument.normalRangeHi = audioBank[currentOffset + 2];
+			instrument.releaseRate = audioBank[currentOffset + 3];
+			instrument.env = ParseEnvelopeData(audioBank, BitConverter::ToInt32BE(audioBank, currentOffset + 4) + ptr, ptr);
 
-			if (BitConverter::ToInt32BE(codeData, currentOffset + 8) != 0)
+			if (BitConverter::ToInt32BE(audioBank, currentOffset + 8) != 0)
 				instrument.lowNotesSound = ParseSoundFontEntry(
-					codeData, audioTable, audioSampleBank[sampleBankId1], sampleBankId1, currentOffset + 8, ptr);
+					audioBank, audioTable, audioSampleBank[sampleBankId1], sampleBankId1, currentOffset + 8, ptr,
+					fontSamples);
 
-			if (BitConverter::ToInt32BE(codeData, currentOffset + 16) != 0)
+			if (BitConverter::ToInt32BE(audioBank, currentOffset + 16) != 0)
 				instrument.normalNotesSound = ParseSoundFontEntry(
-					codeData, audioTable, audioSampleBank[sampleBankId1], sampleBankId1, currentOffset + 16, ptr);
+					audioBank, audioTable, audioSampleBank[sampleBankId1], sampleBankId1, currentOffset + 16, ptr,
+					fontSamples);
 
-			if (BitConverter::ToInt32BE(codeData, currentOffset + 24) != 0 &&
+			if (BitConverter::ToInt32BE(audioBank, currentOffset + 24) != 0 &&
 			    instrument.normalRangeHi != 0x7F)
 				instrument.highNotesSound = ParseSoundFontEntry(
-					codeData, audioTable, audioSampleBank[sampleBankId1], sampleBankId1, currentOffset + 24, ptr);
+					audioBank, audioTable, audioSampleBank[sampleBankId1], sampleBankId1, currentOffset + 24, ptr,
+					fontSamples);
 		}
 
 		entry.instruments.push_back(instrument);
 	}
 }
 
+// Points the references of `font` at the samples which replace them
+static void RemapSamples(AudioTableEntry& font,
+                         const std::map<SampleEntry*, SampleEntry*>& replaced)
+{
+	auto remap = [&replaced](SampleEntry*& sample) {
+		auto it = replaced.find(sample);
+		if (it != replaced.end())
+			sample = it->second;
+	};
+
+	for (DrumEntry& drum : font.drums)
+		remap(drum.sample);
+	for (SoundFontEntry* sfx : font.soundEffects)
+		remap(sfx->sampleEntry);
+	for (InstrumentEntry& instrument : font.instruments)
+	{
+		for (SoundFontEntry* sound :
+		     {instrument.lowNotesSound, instrument.normalNotesSound, instrument.highNotesSound})
+		{
+			if (sound != nullptr)
+				remap(sound->sampleEntry);
+		}
+	}
+}
+
+static bool SamplesMatch(const SampleEntry& a, const SampleEntry& b)
+{
+	// Every field the exporters write has to match, not just the sample data
+	return a.codec == b.codec && a.medium == b.medium && a.unk_bit26 == b.unk_bit26 &&
+	       a.unk_bit25 == b.unk_bit25 && a.sampleLoopOffset == b.sampleLoopOffset &&
+	       a.data == b.data && a.loop.start == b.loop.start &&
+	       a.loop.end == b.loop.end && a.loop.count == b.loop.count &&
+	       a.loop.states == b.loop.states && a.book.order == b.book.order &&
+	       a.book.npredictors == b.book.npredictors && a.book.books == b.book.books;
+}
+
 void ZAudio::ParseRawData()
 {
 	ZResource::ParseRawData();
@@ -351,10 +403,10 @@ void ZAudio::ParseRawData()
 	//int gSampleBankTableOffset = 0x1031C0;
 	//int gSequenceFontTableOffset = 0x102910;
 
-	int gSoundFontTableOffset = StringHelper::StrToL(registeredAttributes.at("SoundFontTableOffset").value, 16);
-	int gSequenceTableOffset = StringHelper::StrToL(registeredAttributes.at("SequenceTableOffset").value, 16);
-	int gSampleBankTableOffset = StringHelper::StrToL(registeredAttributes.at("SampleBankTableOffset").value, 16);
-	int gSequenceFontTableOffset = StringHelper::StrToL(registeredAttributes.at("SequenceFontTableOffset").value, 16);
+	int gSoundFontTableOffset = StringHelper::StrToL(GetAttribute("SoundFontTableOffset").value, 16);
+	int gSequenceTableOffset = StringHelper::StrToL(GetAttribute("SequenceTableOffset").value, 16);
+	int gSampleBankTableOffset = StringHelper::StrToL(GetAttribute("SampleBankTableOffset").value, 16);
+	int gSequenceFontTableOffset = StringHelper::StrToL(GetAttribute("SequenceFontTableOffset").value, 16);
 
 	soundFontTable = ParseAudioTable(codeData, gSoundFontTableOffset);
 	sequenceTable = ParseAudioTable(codeData, gSequenceTableOffset);
@@ -377,28 +429,142 @@ void ZAudio::ParseRawData()
 	}
 
 
-	// SAMPLE/FONT PARSING
-	for (int i = 0; i < soundFontTable.size(); i++)
+	// SAMPLE/FONT AND SEQUENCE PARSING
+	// Every sound font and sequence is a separate job. The results are stored by table index, so
+	// they don't depend on which job finishes first
+	const int num_threads = std::thread::hardware_concurrency();
+	ctpl::thread_pool pool(num_threads > 0 ? num_threads : 1);
+	std::vector<std::future<void>> results;
+	std::vector<std::map<uint32_t, SampleEntry*>> fontSamples(soundFontTable.size());
+
+	for (size_t i = 0; i < soundFontTable.size(); i++)
 	{
-		ParseSoundFont(audioBankData, audioTableData, sampleBankTable, soundFontTable[i]);
+		results.push_back(pool.push([&, i](int) {
+			ParseSoundFont(audioBankData, audioTableData, sampleBankTable, soundFontTable[i],
+			               fontSamples[i]);
+		}));
 	}
 
-	// SEQUENCE PARSING
-	for (int i = 0; i < sequenceTable.size(); i++)
+	sequences.resize(sequenceTable.size());
+	for (size_t i = 0; i < sequenceTable.size(); i++)
 	{
-		int seqDestIdx = i;
+		results.push_back(pool.push([&, i](int) {
+			size_t seqDestIdx = i;
+
+			if (sequenceTable[i].size == 0)
+				seqDestIdx = sequenceTable[i].ptr;
+
+			const AudioTableEntry& seqEntry = sequenceTable.at(seqDestIdx);
+			BulkDecode::CheckBounds(audioSeqData, seqEntry.ptr, seqEntry.size,
+			                        "ZAudio::ParseRawData");
+			sequences[i].assign(audioSeqData.begin() + seqEntry.ptr,
+			                    audioSeqData.begin() + seqEntry.ptr + seqEntry.size);
+		}));
+	}
+
+	// get() rethrows the first error, after waiting for the jobs before it
+	for (auto& result : results)
+		result.wait();
+	for (auto& result : results)
+		result.get();
+
+	// Fonts parsed one after another used to share their samples through one map. Keep that by
+	// merging in table order, pointing later fonts at the first copy of a sample
+	for (size_t i = 0; i < fontSamples.size(); i++)
+	{
+		std::map<SampleEntry*, SampleEntry*> replaced;
+
+		for (const auto& [offset, sample] : fontSamples[i])
+		{
+			auto inserted = samples.emplace(offset, sample);
+			if (!inserted.second)
+				replaced[sample] = inserted.first->second;
+		}
 
-		if (sequenceTable[i].size == 0)
-			seqDestIdx = sequenceTable[i].ptr;
+		if (replaced.empty())
+			continue;
 
-		std::vector<char> seqVec = std::vector<char>(sequenceTable[seqDestIdx].size);
-		memcpy(seqVec.data(), audioSeqData.data() + sequenceTable[seqDestIdx].ptr,
-		       sequenceTable[seqDestIdx].size);
+		RemapSamples(soundFontTable[i], replaced);
 
-		sequences.push_back(seqVec);
+		for (const auto& pair : replaced)
+			delete pair.first;
+	}
+
+	if (Globals::Instance->dedupAudioSamples)
+		DeduplicateSamples();
+
+	// Each sample only touches its own buffer, so they are all decoded at once
+	if (Globals::Instance->exportAudioPCM)
+	{
+		results.clear();
+
+		for (const auto& pair : samples)
+		{
+			SampleEntry* sample = pair.second;
+			results.push_back(pool.push([this, sample](int) { DecodeADPCMSample(sample); }));
+		}
+
+		for (auto& result : results)
+			result.wait();
+		for (auto& result : results)
+			result.get();
 	}
 }
 
+void ZAudio::DeduplicateSamples()
+{
+	// Samples with the same key are compared in full, so a hash collision can't merge them
+	using SampleKey =
+		std::tuple<uint8_t, uint8_t, uint8_t, uint8_t, uint32_t, size_t, uint32_t, uint32_t>;
+	std::map<SampleKey, std::vector<SampleEntry*>> unique;
+	std::map<SampleEntry*, SampleEntry*> replaced;
+
+	for (auto it = samples.begin(); it != samples.end();)
+	{
+		SampleEntry* sample = it->second;
+		uint32_t hash = CRC32B(sample->data.data(), static_cast<int32_t>(sample->data.size()));
+		SampleKey key = {sample->codec,      sample->medium,           sample->unk_bit26,
+		                 sample->unk_bit25,  sample->sampleLoopOffset, sample->data.size(),
+		                 hash,               sample->loop.end};
+		std::vector<SampleEntry*>& candidates = unique[key];
+
+		auto match =
+			std::find_if(candidates.begin(), candidates.end(),
+		                 [sample](const SampleEntry* other) { return SamplesMatch(*sample, *other); });
+
+		if (match == candidates.end())
+		{
+			candidates.push_back(sample);
+			++it;
+			continue;
+		}
+
+		replaced[sample] = *match;
+		sampleDedupCount.fetch_add(1, std::memory_order_relaxed);
+		sampleDedupBytes.fetch_add(sample->data.size(), std::memory_order_relaxed);
+		it = samples.erase(it);
+	}
+
+	if (replaced.empty())
+		return;
+
+	for (AudioTableEntry& font : soundFontTable)
+		RemapSamples(font, replaced);
+
+	for (const auto& pair : replaced)
+		delete pair.first;
+}
+
+void ZAudio::PrintSampleDedupReport()
+{
+	if (!Globals::Instance->dedupAudioSamples)
+		return;
+
+	printf("Audio sample dedup: %" PRIu64 " duplicate samples (%" PRIu64 " KB not exported)\n",
+	       sampleDedupCount.load(std::memory_order_relaxed),
+	       sampleDedupBytes.load(std::memory_order_relaxed) / 1024);
+}
+
 std::string ZAudio::GetSourceTypeName() const
 {
 	return "u8";
@@ -409,6 +575,11 @@ size_t ZAudio::GetRawDataSize() const
 	return 1;
 }
 
+bool ZAudio::HasBodySourceCode() const
+{
+	return false;
+}
+
 ZResourceType ZAudio::GetResourceType() const
 {
 	return ZResourceType::Audio;
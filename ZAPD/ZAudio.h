@@ -38,6 +38,8 @@ struct SampleEntry
 	std::vector<uint8_t> data;
 	AdpcmLoop loop;
 	AdpcmBook book;
+
+	std::vector<int16_t> pcm;  // The decoded samples, only filled with `-apcm 1`
 };
 
 struct SoundFontEntry
@@ -107,27 +109,45 @@ public:
 
 	void ParseXML(tinyxml2::XMLElement* reader) override;
 
+	// Decodes the sample into its `pcm` buffer
 	void DecodeADPCMSample(SampleEntry* sample);
-	std::vector<AdsrEnvelope*> ParseEnvelopeData(std::vector<uint8_t> audioBank, std::vector<uint8_t> audioTable,
-	                               int envelopeOffset, int baseOffset);
-
-	SoundFontEntry* ParseSoundFontEntry(std::vector<uint8_t> audioBank,
-	                                    std::vector<uint8_t> audioTable,
-	                                    AudioTableEntry audioSampleBankEntry, int bankIndex,
-	                                    int soundFontOffset,
-	                                    int baseOffset);
 
-	SampleEntry* ParseSampleEntry(std::vector<uint8_t> audioBank, std::vector<uint8_t> audioTable,
-	                              AudioTableEntry audioSampleBankEntry, int bankIndex,
-	                              int sampleOffset, int baseOffset);
-
-	std::vector<AudioTableEntry> ParseAudioTable(std::vector<uint8_t> codeData, int baseOffset);
-	void ParseSoundFont(std::vector<uint8_t> codeData, std::vector<uint8_t> audioTable,
-	                    std::vector<AudioTableEntry> audioSampleBank, AudioTableEntry& entry);
+	// The parsers below only read from the audio files, which are loaded once by ParseRawData
+	std::vector<AdsrEnvelope*> ParseEnvelopeData(const std::vector<uint8_t>& audioBank,
+	                                             int envelopeOffset, int baseOffset);
+
+	// Sound fonts are parsed in parallel, so each one collects its samples in `fontSamples`,
+	// keyed by offset in the Audiobank
+	SoundFontEntry* ParseSoundFontEntry(const std::vector<uint8_t>& audioBank,
+	                                    const std::vector<uint8_t>& audioTable,
+	                                    const AudioTableEntry& audioSampleBankEntry, int bankIndex,
+	                                    int soundFontOffset, int baseOffset,
+	                                    std::map<uint32_t, SampleEntry*>& fontSamples);
+
+	SampleEntry* ParseSampleEntry(const std::vector<uint8_t>& audioBank,
+	                              const std::vector<uint8_t>& audioTable,
+	                              const AudioTableEntry& audioSampleBankEntry, int bankIndex,
+	                              int sampleOffset, int baseOffset,
+	                              std::map<uint32_t, SampleEntry*>& fontSamples);
+
+	std::vector<AudioTableEntry> ParseAudioTable(const std::vector<uint8_t>& codeData,
+	                                             int baseOffset);
+	void ParseSoundFont(const std::vector<uint8_t>& audioBank,
+	                    const std::vector<uint8_t>& audioTable,
+	                    const std::vector<AudioTableEntry>& audioSampleBank, AudioTableEntry& entry,
+	                    std::map<uint32_t, SampleEntry*>& fontSamples);
 
 	void ParseRawData() override;
 
+	/**
+	 * Keeps one sample per distinct data, codec, loop and book, and points every sound font at
+	 * it. The first sample by offset is kept, the others are deleted.
+	 */
+	void DeduplicateSamples();
+	static void PrintSampleDedupReport();
+
 	std::string GetSourceTypeName() const override;
+	bool HasBodySourceCode() const override;
 	ZResourceType GetResourceType() const override;
 
 	size_t GetRawDataSize() const override;
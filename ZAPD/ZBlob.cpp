@@ -1,6 +1,7 @@
 #include "ZBlob.h"
 
 #include "Globals.h"
+#include "SourceEmitter.h"
 #include "Utils/BitConverter.h"
 #include <Utils/DiskFile.h>
 #include "Utils/Path.h"
@@ -9,10 +10,14 @@
 
 REGISTER_ZFILENODE(Blob, ZBlob);
 
+static const ResourceAttributeSchema blobAttributes(&ZResource::commonAttributes, {
+	{"Size", true},
+});
+
 ZBlob::ZBlob(ZFile* nParent) : ZResource(nParent)
 {
 	genOTRDef = true;
-	RegisterRequiredAttribute("Size");
+	attributeSchema = &blobAttributes;
 }
 
 ZBlob* ZBlob::FromFile(const std::string& filePath)
@@ -28,7 +33,7 @@ void ZBlob::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	blobSize = StringHelper::StrToL(registeredAttributes.at("Size").value, 16);
+	blobSize = StringHelper::StrToL(GetAttribute("Size").value, 16);
 }
 
 void ZBlob::ParseRawData()
@@ -65,21 +70,27 @@ std::string ZBlob::GetBodySourceCode() const
 {
 	std::string sourceOutput;
 
-	for (size_t i = 0; i < blobData.size(); i += 1)
-	{
-		if (i % 16 == 0)
-			sourceOutput += "\t";
-
-		sourceOutput += StringHelper::Sprintf("0x%02X, ", blobData[i]);
-
-		if (i % 16 == 15)
-			sourceOutput += "\n";
-	}
-
-	// Ensure there's always a trailing line feed to prevent dumb warnings.
-	// Please don't remove this line, unless you somehow made a way to prevent
-	// that warning when building the OoT repo.
-	sourceOutput += "\n";
+	// Each byte is "0x%02X, ", plus a tab and a line feed every 16 bytes
+	SourceEmitter::Append(sourceOutput, blobData.size() * 7 + 1, [this](char* dst) {
+		for (size_t i = 0; i < blobData.size(); i += 1)
+		{
+			if (i % 16 == 0)
+				*dst++ = '\t';
+
+			dst = SourceEmitter::Text(dst, "0x");
+			dst = SourceEmitter::Hex(dst, blobData[i], 2);
+			dst = SourceEmitter::Text(dst, ", ");
+
+			if (i % 16 == 15)
+				*dst++ = '\n';
+		}
+
+		// Ensure there's always a trailing line feed to prevent dumb warnings.
+		// Please don't remove this line, unless you somehow made a way to prevent
+		// that warning when building the OoT repo.
+		*dst++ = '\n';
+		return dst;
+	});
 
 	return sourceOutput;
 }
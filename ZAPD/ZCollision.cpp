@@ -1,16 +1,26 @@
 #include "ZCollision.h"
 #include "ZWaterbox.h"
 
+#include <atomic>
 #include <cassert>
+#include <chrono>
+#include <cinttypes>
 #include <cstdint>
 #include <string>
 
+#include "BulkDecode.h"
 #include "Globals.h"
 #include "Utils/BitConverter.h"
 #include "Utils/StringHelper.h"
 
 REGISTER_ZFILENODE(Collision, ZCollisionHeader);
 
+static std::atomic<uint64_t> bvhBuildCount{0};
+static std::atomic<uint64_t> bvhPolyCount{0};
+static std::atomic<uint64_t> bvhNodeCount{0};
+static std::atomic<uint64_t> bvhLeafCount{0};
+static std::atomic<uint64_t> bvhBuildMicroseconds{0};
+
 ZCollisionHeader::ZCollisionHeader(ZFile* nParent) : ZResource(nParent)
 {
 	genOTRDef = true;
@@ -50,46 +60,20 @@ void ZCollisionHeader::ParseRawData()
 	camDataSegmentOffset = Seg2Filespace(camDataAddress, parent->baseAddress);
 	waterBoxSegmentOffset = Seg2Filespace(waterBoxAddress, parent->baseAddress);
 
-	vertices.reserve(numVerts);
-	polygons.reserve(numPolygons);
 	waterBoxes.reserve(numWaterBoxes);
 
-	offset_t currentPtr = vtxSegmentOffset;
-
-	for (uint16_t i = 0; i < numVerts; i++)
-	{
-		ZVector vec(parent);
-		vec.ExtractFromBinary(currentPtr, ZScalarType::ZSCALAR_S16, 3);
-
-		currentPtr += vec.GetRawDataSize();
-		vertices.push_back(vec);
-	}
-
-	for (uint16_t i = 0; i < numPolygons; i++)
-	{
-		ZCollisionPoly poly(parent);
-		poly.SetRawDataIndex(polySegmentOffset + (i * 16));
-		poly.ParseRawData();
-		polygons.push_back(poly);
-	}
+	vertices.ParseRawData(rawData, vtxSegmentOffset, numVerts);
+	polygons.ParseRawData(rawData, polySegmentOffset, numPolygons);
 
 	uint16_t highestPolyType = 0;
 
-	for (const ZCollisionPoly& poly : polygons)
+	for (uint16_t polyType : polygons.type)
 	{
-		if (poly.type > highestPolyType)
-			highestPolyType = poly.type;
+		if (polyType > highestPolyType)
+			highestPolyType = polyType;
 	}
 
-	for (uint16_t i = 0; i < highestPolyType + 1; i++)
-	{
-		ZSurfaceType surfaceType(parent);
-		surfaceType.SetRawDataIndex(polyTypeDefSegmentOffset + (i * 8));
-		surfaceType.ParseRawData();
-		polygonTypes.push_back(surfaceType);
-	}
-	// polygonTypes.push_back(
-	//	BitConverter::ToUInt64BE(rawData, polyTypeDefSegmentOffset + (i * 8)));
+	polygonTypes.ParseRawData(rawData, polyTypeDefSegmentOffset, highestPolyType + 1);
 
 	if (camDataAddress != SEGMENTED_NULL)
 	{
@@ -149,6 +133,21 @@ void ZCollisionHeader::ParseRawData()
 		waterbox.ParseRawData();
 		waterBoxes.emplace_back(waterbox);
 	}
+
+	// Scenes are extracted in parallel, so each header builds its own tree on its file's thread
+	if (Globals::Instance->buildCollisionBVH)
+	{
+		auto start = std::chrono::steady_clock::now();
+		bvh.Build(vertices, polygons);
+		auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+			std::chrono::steady_clock::now() - start);
+
+		bvhBuildCount.fetch_add(1, std::memory_order_relaxed);
+		bvhPolyCount.fetch_add(polygons.size(), std::memory_order_relaxed);
+		bvhNodeCount.fetch_add(bvh.nodes.size(), std::memory_order_relaxed);
+		bvhLeafCount.fetch_add(bvh.leafCount, std::memory_order_relaxed);
+		bvhBuildMicroseconds.fetch_add(elapsed.count(), std::memory_order_relaxed);
+	}
 }
 
 void ZCollisionHeader::DeclareReferences(const std::string& prefix)
@@ -187,28 +186,31 @@ void ZCollisionHeader::DeclareReferences(const std::string& prefix)
 		{
 			for (size_t i = 0; i < polygons.size(); i++)
 			{
-				declaration += StringHelper::Sprintf("\t%s,", polygons[i].GetBodySourceCode().c_str());
+				declaration += StringHelper::Sprintf("\t%s,", polygons.GetBodySourceCode(i).c_str());
 				if (i + 1 < polygons.size())
 					declaration += "\n";
 			}
 		}
 
 		parent->AddDeclarationArray(polySegmentOffset, DeclarationAlignment::Align4,
-		                            polygons.size() * 16, polygons[0].GetSourceTypeName().c_str(),
+		                            polygons.size() * 16, "CollisionPoly",
 		                            StringHelper::Sprintf("%sPolygons", auxName.c_str()),
 		                            polygons.size(), declaration);
 	}
 
 	declaration.clear();
-	for (const auto& polyType : polygonTypes)
+	if (!Globals::Instance->binaryOnly)
 	{
-		declaration += StringHelper::Sprintf("\t%s,", polyType.GetBodySourceCode().c_str());
+		for (size_t i = 0; i < polygonTypes.size(); i++)
+		{
+			declaration +=
+				StringHelper::Sprintf("\t%s,", polygonTypes.GetBodySourceCode(i).c_str());
+		}
 	}
 
 	if (polyTypeDefAddress != SEGMENTED_NULL)
 		parent->AddDeclarationArray(polyTypeDefSegmentOffset, DeclarationAlignment::Align4,
-		                            polygonTypes.size() * 8,
-		                            polygonTypes[0].GetSourceTypeName().c_str(),
+		                            polygonTypes.size() * 8, "SurfaceType",
 		                            StringHelper::Sprintf("%sSurfaceType", auxName.c_str()),
 		                            polygonTypes.size(), declaration);
 
@@ -223,18 +225,16 @@ void ZCollisionHeader::DeclareReferences(const std::string& prefix)
 			for (size_t i = 0; i < vertices.size(); i++)
 			{
 				declaration +=
-					StringHelper::Sprintf("\t{ %s },", vertices[i].GetBodySourceCode().c_str());
+					StringHelper::Sprintf("\t{ %s },", vertices.GetBodySourceCode(i).c_str());
 
 				if (i < vertices.size() - 1)
 					declaration += "\n";
 			}
 		}
 
-		const auto& first = vertices.front();
 		if (vtxAddress != 0)
 			parent->AddDeclarationArray(
-				vtxSegmentOffset, first.GetDeclarationAlignment(),
-				vertices.size() * first.GetRawDataSize(), first.GetSourceTypeName(),
+				vtxSegmentOffset, DeclarationAlignment::Align4, vertices.size() * 6, "Vec3s",
 				StringHelper::Sprintf("%sVertices", auxName.c_str()), vertices.size(), declaration);
 	}
 }
@@ -308,6 +308,108 @@ size_t ZCollisionHeader::GetRawDataSize() const
 {
 	return 44;
 }
+
+void ZCollisionHeader::PrintBVHReport()
+{
+	uint64_t count = bvhBuildCount.load(std::memory_order_relaxed);
+	if (count == 0)
+		return;
+
+	printf("Collision BVH: %" PRIu64 " headers, %" PRIu64 " polygons, %" PRIu64 " nodes (%" PRIu64
+	       " leaves), built in %.2f ms\n",
+	       count, bvhPolyCount.load(std::memory_order_relaxed),
+	       bvhNodeCount.load(std::memory_order_relaxed),
+	       bvhLeafCount.load(std::memory_order_relaxed),
+	       bvhBuildMicroseconds.load(std::memory_order_relaxed) / 1000.0);
+}
+
+static void CheckCollisionListBounds(const std::vector<uint8_t>& rawData, offset_t offset,
+                                     size_t count, size_t elementSize, const char* listName)
+{
+	if (offset + count * elementSize > rawData.size())
+	{
+		throw std::runtime_error(StringHelper::Sprintf(
+			"ZCollisionHeader: %s list at 0x%06X with %zu elements is out of bounds", listName,
+			offset, count));
+	}
+}
+
+void CollisionVertexList::ParseRawData(const std::vector<uint8_t>& rawData, offset_t offset,
+                                       size_t count)
+{
+	CheckCollisionListBounds(rawData, offset, count, 6, "vertex");
+
+	const uint8_t* data = rawData.data() + offset;
+
+	x.resize(count);
+	y.resize(count);
+	z.resize(count);
+	BulkDecode::ExtractS16Strided(data + 0, 6, x.data(), count);
+	BulkDecode::ExtractS16Strided(data + 2, 6, y.data(), count);
+	BulkDecode::ExtractS16Strided(data + 4, 6, z.data(), count);
+}
+
+size_t CollisionVertexList::size() const
+{
+	return x.size();
+}
+
+std::string CollisionVertexList::GetBodySourceCode(size_t index) const
+{
+	return StringHelper::Sprintf("%6hd, %6hd, %6hd", x[index], y[index], z[index]);
+}
+
+void CollisionPolyList::ParseRawData(const std::vector<uint8_t>& rawData, offset_t offset,
+                                     size_t count)
+{
+	CheckCollisionListBounds(rawData, offset, count, 16, "poly");
+
+	const uint8_t* data = rawData.data() + offset;
+
+	for (auto* field : {&type, &vtxA, &vtxB, &vtxC, &normX, &normY, &normZ, &dist})
+		field->resize(count);
+
+	// The fields are in record order
+	uint16_t* const fields[8] = {type.data(),  vtxA.data(),  vtxB.data(),  vtxC.data(),
+	                             normX.data(), normY.data(), normZ.data(), dist.data()};
+	BulkDecode::DeinterleaveU16x8(data, fields, count);
+}
+
+size_t CollisionPolyList::size() const
+{
+	return type.size();
+}
+
+std::string CollisionPolyList::GetBodySourceCode(size_t index) const
+{
+	return StringHelper::Sprintf(
+		"{0x%04X, 0x%04X, 0x%04X, 0x%04X, 0x%04X, 0x%04X, 0x%04X, 0x%04X}", type[index],
+		vtxA[index], vtxB[index], vtxC[index], normX[index], normY[index], normZ[index],
+		dist[index]);
+}
+
+void SurfaceTypeList::ParseRawData(const std::vector<uint8_t>& rawData, offset_t offset,
+                                   size_t count)
+{
+	CheckCollisionListBounds(rawData, offset, count, 8, "surface type");
+
+	const uint8_t* data = rawData.data() + offset;
+
+	data0.resize(count);
+	data1.resize(count);
+	BulkDecode::ExtractU32Strided(data + 0, 8, data0.data(), count);
+	BulkDecode::ExtractU32Strided(data + 4, 8, data1.data(), count);
+}
+
+size_t SurfaceTypeList::size() const
+{
+	return data0.size();
+}
+
+std::string SurfaceTypeList::GetBodySourceCode(size_t index) const
+{
+	return StringHelper::Sprintf("{0x%08X, 0x%08X}", data0[index], data1[index]);
+}
 #if 0
 WaterBoxHeader::WaterBoxHeader(const std::vector<uint8_t>& rawData, uint32_t rawDataIndex)
 {
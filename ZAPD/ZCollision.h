@@ -1,5 +1,6 @@
 #pragma once
 
+#include "CollisionBVH.h"
 #include "ZCollisionPoly.h"
 #include "ZFile.h"
 #include "ZResource.h"
@@ -8,6 +9,51 @@
 #include "ZVector.h"
 #include "ZWaterbox.h"
 
+/**
+ * Struct-of-arrays storage for the collision vertices (Vec3s)
+ */
+class CollisionVertexList
+{
+public:
+	std::vector<int16_t> x, y, z;
+
+	void ParseRawData(const std::vector<uint8_t>& rawData, offset_t offset, size_t count);
+
+	[[nodiscard]] size_t size() const;
+	[[nodiscard]] std::string GetBodySourceCode(size_t index) const;
+};
+
+/**
+ * Struct-of-arrays storage for the CollisionPoly list
+ */
+class CollisionPolyList
+{
+public:
+	std::vector<uint16_t> type;
+	std::vector<uint16_t> vtxA, vtxB, vtxC;
+	std::vector<uint16_t> normX, normY, normZ;
+	std::vector<uint16_t> dist;
+
+	void ParseRawData(const std::vector<uint8_t>& rawData, offset_t offset, size_t count);
+
+	[[nodiscard]] size_t size() const;
+	[[nodiscard]] std::string GetBodySourceCode(size_t index) const;
+};
+
+/**
+ * Struct-of-arrays storage for the SurfaceType list
+ */
+class SurfaceTypeList
+{
+public:
+	std::vector<uint32_t> data0, data1;
+
+	void ParseRawData(const std::vector<uint8_t>& rawData, offset_t offset, size_t count);
+
+	[[nodiscard]] size_t size() const;
+	[[nodiscard]] std::string GetBodySourceCode(size_t index) const;
+};
+
 class CameraPositionData
 {
 public:
@@ -53,11 +99,12 @@ public:
 	uint32_t vtxSegmentOffset, polySegmentOffset, polyTypeDefSegmentOffset, camDataSegmentOffset,
 		waterBoxSegmentOffset;
 
-	std::vector<ZVector> vertices;
-	std::vector<ZCollisionPoly> polygons;
-	std::vector<ZSurfaceType> polygonTypes;
+	CollisionVertexList vertices;
+	CollisionPolyList polygons;
+	SurfaceTypeList polygonTypes;
 	std::vector<ZWaterbox> waterBoxes;
 	CameraDataList* camData = nullptr;
+	CollisionBVH bvh;  // Only built with `-colbvh 1`
 
 	ZCollisionHeader(ZFile* nParent);
 	~ZCollisionHeader();
@@ -72,4 +119,6 @@ public:
 	ZResourceType GetResourceType() const override;
 
 	size_t GetRawDataSize() const override;
+
+	static void PrintBVHReport();
 };
@@ -1,10 +1,12 @@
 #include "ZDisplayList.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <cinttypes>
 #include <cmath>
+#include <set>
 
 #include "Globals.h"
 #include "OutputFormatter.h"
@@ -135,6 +137,34 @@
 
 REGISTER_ZFILENODE(DList, ZDisplayList);
 
+static const ResourceAttributeSchema displayListAttributes(&ZResource::commonAttributes, {
+	{"Ucode", false},
+});
+
+static std::atomic<uint64_t> dListDecodeCount{0};
+static std::atomic<uint64_t> dListDecodeHits{0};
+static std::atomic<uint64_t> dListGfxdCount{0};
+static std::atomic<uint64_t> dListGfxdHits{0};
+
+static const DListCacheEntry& GetDListCacheEntry(ZFile* file, uint32_t offset, DListType type)
+{
+	auto& entry = file->dListCache[{offset, static_cast<int>(type)}];
+
+	dListDecodeCount.fetch_add(1, std::memory_order_relaxed);
+	if (entry != nullptr)
+	{
+		dListDecodeHits.fetch_add(1, std::memory_order_relaxed);
+		return *entry;
+	}
+
+	auto newEntry = std::make_unique<DListCacheEntry>();
+	newEntry->scan =
+		ZDisplayList::ScanDList(file->GetRawData(), offset, type, &newEntry->instructions);
+
+	entry = std::move(newEntry);
+	return *entry;
+}
+
 ZDisplayList::ZDisplayList(ZFile* nParent) : ZResource(nParent)
 {
 	lastTexWidth = 0;
@@ -147,7 +177,7 @@ ZDisplayList::ZDisplayList(ZFile* nParent) : ZResource(nParent)
 	lastTexIsPalette = false;
 	dListType = Globals::Instance->game == ZGame::OOT_SW97 ? DListType::F3DEX : DListType::F3DZEX;
 	genOTRDef = true;
-	RegisterOptionalAttribute("Ucode");
+	attributeSchema = &displayListAttributes;
 }
 
 ZDisplayList::~ZDisplayList()
@@ -164,8 +194,8 @@ void ZDisplayList::ExtractWithXML(tinyxml2::XMLElement* reader, uint32_t nRawDat
 	rawDataIndex = nRawDataIndex;
 	ParseXML(reader);
 	// TODO add error handling here
-	bool ucodeSet = registeredAttributes.at("Ucode").wasSet;
-	std::string ucodeValue = registeredAttributes.at("Ucode").value;
+	bool ucodeSet = GetAttribute("Ucode").wasSet;
+	std::string ucodeValue = GetAttribute("Ucode").value;
 	if ((Globals::Instance->game == ZGame::OOT_SW97) || (ucodeValue == "f3dex"))
 	{
 		dListType = DListType::F3DEX;
@@ -184,10 +214,9 @@ void ZDisplayList::ExtractWithXML(tinyxml2::XMLElement* reader, uint32_t nRawDat
 	// Don't parse raw data of external files
 	if (parent->GetMode() != ZFileMode::ExternalFile)
 	{
-		int32_t rawDataSize =
-			ZDisplayList::GetDListLength(parent->GetRawData(), rawDataIndex, dListType);
-		numInstructions = rawDataSize / 8;
-		ParseRawData();
+		const DListCacheEntry& entry = GetDListCacheEntry(parent, rawDataIndex, dListType);
+		numInstructions = entry.instructions.size();
+		instructions = entry.instructions;
 	}
 
 	Declaration* decl = DeclareVar("", "");
@@ -207,6 +236,21 @@ void ZDisplayList::ExtractFromBinary(uint32_t nRawDataIndex, int32_t rawDataSize
 	ParseRawData();
 }
 
+void ZDisplayList::ExtractFromBinary(uint32_t nRawDataIndex, DListType scanType)
+{
+	rawDataIndex = nRawDataIndex;
+	name = GetDefaultName(parent->GetName());
+
+	const DListCacheEntry& entry = GetDListCacheEntry(parent, rawDataIndex, scanType);
+	numInstructions = entry.instructions.size();
+
+	// Don't parse raw data of external files
+	if (parent->GetMode() == ZFileMode::ExternalFile)
+		return;
+
+	instructions = entry.instructions;
+}
+
 void ZDisplayList::ParseRawData()
 {
 	const auto& rawData = parent->GetRawData();
@@ -411,8 +455,7 @@ void ZDisplayList::ParseF3DZEX(F3DZEXOpcode opcode, uint64_t data, int32_t i,
 			        h & 0x00FFFFFF, (a / 5) | (b / 2), z);
 
 			ZDisplayList* nList = new ZDisplayList(parent);
-			nList->ExtractFromBinary(
-				h & 0x00FFFFFF, GetDListLength(parent->GetRawData(), h & 0x00FFFFFF, dListType));
+			nList->ExtractFromBinary(h & 0x00FFFFFF, dListType);
 			nList->SetName(nList->GetDefaultName(prefix));
 			otherDLists.push_back(nList);
 
@@ -562,6 +605,12 @@ void ZDisplayList::ParseF3DEX(F3DEXOpcode opcode, uint64_t data, const std::stri
 
 int32_t ZDisplayList::GetDListLength(const std::vector<uint8_t>& rawData, uint32_t rawDataIndex,
                                      DListType dListType)
+{
+	return ScanDList(rawData, rawDataIndex, dListType).length;
+}
+
+DListScan ZDisplayList::ScanDList(const std::vector<uint8_t>& rawData, uint32_t rawDataIndex,
+                                  DListType dListType, std::vector<uint64_t>* instructions)
 {
 	uint8_t endDLOpcode;
 	uint8_t branchListOpcode;
@@ -577,11 +626,15 @@ int32_t ZDisplayList::GetDListLength(const std::vector<uint8_t>& rawData, uint32
 		branchListOpcode = static_cast<uint8_t>(F3DEXOpcode::G_DL);
 	}
 
+	DListScan scan;
+	// Only the F3DZEX encodings of the referencing commands are known here, gfxd handles the rest
+	scan.needsGfxd = dListType != DListType::F3DZEX;
+
 	uint32_t ptr = rawDataIndex;
 	size_t rawDataSize = rawData.size();
 	while (true)
 	{
-		if (ptr >= rawDataSize)
+		if (ptr + 8 > rawDataSize)
 		{
 			std::string errorHeader =
 				StringHelper::Sprintf("reached end of file when trying to find the end of the "
@@ -591,13 +644,56 @@ int32_t ZDisplayList::GetDListLength(const std::vector<uint8_t>& rawData, uint32
 			HANDLE_ERROR_PROCESS(WarningType::Always, errorHeader, errorBody);
 		}
 
-		uint8_t opcode = rawData.at(ptr);
-		bool dlNoPush = rawData.at(ptr + 1) == 1;
+		const uint8_t* command = rawData.data() + ptr;
+		uint32_t w0 = BitConverter::ToUInt32BE(command, 0);
+		uint32_t w1 = BitConverter::ToUInt32BE(command, 4);
+		uint8_t opcode = command[0];
+		bool dlNoPush = command[1] == 1;
 		ptr += 8;
 
+		if (instructions != nullptr)
+			instructions->push_back((static_cast<uint64_t>(w0) << 32) | w1);
+
+		if (!scan.needsGfxd)
+		{
+			// These mirror the gfxd macros which call the vtx, dl and mtx callbacks
+			switch (static_cast<F3DZEXOpcode>(opcode))
+			{
+			case F3DZEXOpcode::G_VTX:
+				scan.references.push_back(
+					{DListReferenceType::Vertex, w1, static_cast<int32_t>((w0 >> 12) & 0xFF)});
+				break;
+			case F3DZEXOpcode::G_DL:
+				scan.references.push_back({DListReferenceType::DisplayList, w1, 0});
+				break;
+			case F3DZEXOpcode::G_MTX:
+				// gfxd doesn't decode matrices of any other size
+				if (((w0 >> 19) & 0x1F) == 7)
+					scan.references.push_back({DListReferenceType::Matrix, w1, 0});
+				break;
+			case F3DZEXOpcode::G_RDPHALF_1:
+				// gsSPBranchLessZraw, the branch target is the G_RDPHALF_1 word
+				if (ptr < rawDataSize &&
+				    rawData[ptr] == static_cast<uint8_t>(F3DZEXOpcode::G_BRANCH_Z))
+					scan.references.push_back({DListReferenceType::DisplayList, w1, 0});
+				break;
+			case F3DZEXOpcode::G_SETTIMG:
+			case F3DZEXOpcode::G_LOADTLUT:
+				scan.loadsTextures = true;
+				break;
+			case F3DZEXOpcode::G_MOVEMEM:
+				// gsSPForceMatrix
+				scan.needsGfxd = true;
+				break;
+			default:
+				break;
+			}
+		}
+
 		if (opcode == endDLOpcode || (opcode == branchListOpcode && dlNoPush))
 		{
-			return ptr - rawDataIndex;
+			scan.length = ptr - rawDataIndex;
+			return scan;
 		}
 	}
 }
@@ -856,8 +952,7 @@ void ZDisplayList::Opcode_G_DL(uint64_t data, const std::string& prefix, char* l
 	else
 	{
 		ZDisplayList* nList = new ZDisplayList(parent);
-		nList->ExtractFromBinary(GETSEGOFFSET(data), GetDListLength(parent->GetRawData(),
-		                                                            GETSEGOFFSET(data), dListType));
+		nList->ExtractFromBinary(GETSEGOFFSET(data), dListType);
 		nList->SetName(nList->GetDefaultName(prefix));
 
 		otherDLists.push_back(nList);
@@ -1004,21 +1099,7 @@ void ZDisplayList::Opcode_G_VTX(uint64_t data, char* line)
 		}
 
 		if (nn > 0)
-		{
-			std::vector<ZVtx> vtxList;
-			vtxList.reserve(nn);
-
-			for (int32_t i = 0; i < nn; i++)
-			{
-				ZVtx vtx(parent);
-				vtx.ExtractFromFile(currentPtr);
-				vtxList.push_back(vtx);
-
-				currentPtr += 16;
-			}
-
-			vertices[vtxAddr] = vtxList;
-		}
+			VtxData::ParseList(parent->GetRawData(), currentPtr, nn, vertices[vtxAddr]);
 	}
 }
 
@@ -1715,9 +1796,8 @@ static int32_t GfxdCallback_FormatSingleEntry()
 	return 0;
 }
 
-static int32_t GfxdCallback_Vtx(uint32_t seg, int32_t count)
+static void AddVtxReference(ZDisplayList* self, uint32_t seg, int32_t count)
 {
-	ZDisplayList* self = static_cast<ZDisplayList*>(gfxd_udata_get());
 	uint32_t vtxOffset = Seg2Filespace(seg, self->parent->baseAddress);
 
 	if (GETSEGNUM(seg) == self->parent->segment)
@@ -1750,18 +1830,8 @@ static int32_t GfxdCallback_Vtx(uint32_t seg, int32_t count)
 
 		if (count > 0)
 		{
-			std::vector<ZVtx> vtxList;
-			vtxList.reserve(count);
-
-			uint32_t currentPtr = vtxOffset;
-			for (int32_t i = 0; i < count; i++)
-			{
-				ZVtx vtx(self->parent);
-				vtx.ExtractFromFile(currentPtr);
-
-				vtxList.push_back(vtx);
-				currentPtr += 16;
-			}
+			std::vector<VtxData> vtxList;
+			VtxData::ParseList(self->parent->GetRawData(), vtxOffset, count, vtxList);
 
 			bool keyAlreadyOccupied = self->vertices.find(vtxOffset) != self->vertices.end();
 
@@ -1774,7 +1844,14 @@ static int32_t GfxdCallback_Vtx(uint32_t seg, int32_t count)
 	}
 
 	self->references.push_back(seg);
-	
+}
+
+static int32_t GfxdCallback_Vtx(uint32_t seg, int32_t count)
+{
+	ZDisplayList* self = static_cast<ZDisplayList*>(gfxd_udata_get());
+
+	AddVtxReference(self, seg, count);
+
 	if (!Globals::Instance->otrMode)
 		gfxd_puts("@r");
 
@@ -1830,9 +1907,8 @@ static int32_t GfxdCallback_Palette(uint32_t seg, [[maybe_unused]] int32_t idx,
 	return 1;
 }
 
-static int32_t GfxdCallback_DisplayList(uint32_t seg)
+static std::string AddDListReference(ZDisplayList* self, uint32_t seg)
 {
-	ZDisplayList* self = static_cast<ZDisplayList*>(gfxd_udata_get());
 	uint32_t dListOffset = GETSEGOFFSET(seg);
 	uint32_t dListSegNum = GETSEGNUM(seg);
 
@@ -1845,9 +1921,7 @@ static int32_t GfxdCallback_DisplayList(uint32_t seg)
 		if (self->parent->segment == dListSegNum)
 		{
 			ZDisplayList* newDList = new ZDisplayList(self->parent);
-			newDList->ExtractFromBinary(
-				dListOffset,
-				self->GetDListLength(self->parent->GetRawData(), dListOffset, self->dListType));
+			newDList->ExtractFromBinary(dListOffset, self->dListType);
 			newDList->SetName(newDList->GetDefaultName(self->parent->GetName()));
 			self->otherDLists.push_back(newDList);
 			dListName = newDList->GetName();
@@ -1859,15 +1933,22 @@ static int32_t GfxdCallback_DisplayList(uint32_t seg)
 		}
 	}
 
+	return dListName;
+}
+
+static int32_t GfxdCallback_DisplayList(uint32_t seg)
+{
+	ZDisplayList* self = static_cast<ZDisplayList*>(gfxd_udata_get());
+	std::string dListName = AddDListReference(self, seg);
+
 	gfxd_puts(dListName.c_str());
 
 	return 1;
 }
 
-static int32_t GfxdCallback_Matrix(uint32_t seg)
+static std::string AddMtxReference(ZDisplayList* self, uint32_t seg)
 {
 	std::string mtxName;
-	ZDisplayList* self = static_cast<ZDisplayList*>(gfxd_udata_get());
 
 	bool addressFound =
 		Globals::Instance->GetSegmentedPtrName(seg, self->parent, "Mtx", mtxName, false, self->parent->workerID);
@@ -1897,11 +1978,25 @@ static int32_t GfxdCallback_Matrix(uint32_t seg)
 		}
 	}
 
+	return mtxName;
+}
+
+static int32_t GfxdCallback_Matrix(uint32_t seg)
+{
+	ZDisplayList* self = static_cast<ZDisplayList*>(gfxd_udata_get());
+	std::string mtxName = AddMtxReference(self, seg);
+
 	gfxd_puts(mtxName.c_str());
 
 	return 1;
 }
 
+// Binary-only runs still need the callbacks above, but not the text they produce
+static int GfxdCallback_DiscardOutput([[maybe_unused]] const char* buf, int count)
+{
+	return count;
+}
+
 void ZDisplayList::DeclareReferences(const std::string& prefix)
 {
 	std::string sourceOutput;
@@ -1912,46 +2007,21 @@ void ZDisplayList::DeclareReferences(const std::string& prefix)
 		sourceOutput += ProcessGfxDis(prefix);
 
 	// Iterate through our vertex lists, connect intersecting lists.
+	MergeVertexLists(vertices, false);
+
 	if (vertices.size() > 0)
 	{
-		std::vector<std::pair<uint32_t, std::vector<ZVtx>>> verticesSorted(vertices.begin(),
-		                                                                   vertices.end());
-
-		for (size_t i = 0; i < verticesSorted.size() - 1; i++)
-		{
-			size_t vtxSize = vertices[verticesSorted[i].first].size() * 16;
-
-			if ((verticesSorted[i].first + vtxSize) > verticesSorted[i + 1].first)
-			{
-				int32_t intersectAmt =
-					(verticesSorted[i].first + vtxSize) - verticesSorted[i + 1].first;
-				int32_t intersectIndex = intersectAmt / 16;
-
-				for (size_t j = intersectIndex; j < verticesSorted[i + 1].second.size(); j++)
-					vertices[verticesSorted[i].first].push_back(verticesSorted[i + 1].second[j]);
-
-				vertices.erase(verticesSorted[i + 1].first);
-				verticesSorted.erase(verticesSorted.begin() + i + 1);
-
-				i--;
-			}
-		}
-
 		// Generate Vertex Declarations
 		for (auto& item : vertices)
 		{
-			std::string declaration = "";
-
 			offset_t curAddr = item.first;
-			auto& firstVtx = item.second.at(0);
 
-			for (auto vtx : item.second)
-				declaration += StringHelper::Sprintf("\t%s,\n", vtx.GetBodySourceCode().c_str());
+			std::string declaration = VtxData::GetListBodySourceCode(item.second);
 
 			Declaration* decl = parent->AddDeclarationArray(
-				curAddr, firstVtx.GetDeclarationAlignment(),
-				item.second.size() * firstVtx.GetRawDataSize(), firstVtx.GetSourceTypeName(),
-				firstVtx.GetDefaultName(name), item.second.size(), declaration);
+				curAddr, DeclarationAlignment::Align8, item.second.size() * 16, "Vtx",
+				StringHelper::Sprintf("%sVtx_%06X", name.c_str(), curAddr), item.second.size(),
+				declaration);
 
 			/*for (auto vtx : item.second)
 			{
@@ -1977,32 +2047,10 @@ void ZDisplayList::DeclareReferences(const std::string& prefix)
 	decl->references = references;
 
 	// Iterate through our vertex lists, connect intersecting lists.
+	MergeVertexLists(vertices, false);
+
 	if (vertices.size() > 0)
 	{
-		std::vector<std::pair<uint32_t, std::vector<ZVtx>>> verticesSorted(vertices.begin(),
-		                                                                   vertices.end());
-
-		for (size_t i = 0; i < verticesSorted.size() - 1; i++)
-		{
-			// int32_t vtxSize = verticesSorted[i].second.size() * 16;
-			size_t vtxSize = vertices[verticesSorted[i].first].size() * 16;
-
-			if ((verticesSorted[i].first + vtxSize) > verticesSorted[i + 1].first)
-			{
-				int32_t intersectAmt =
-					(verticesSorted[i].first + vtxSize) - verticesSorted[i + 1].first;
-				int32_t intersectIndex = intersectAmt / 16;
-
-				for (size_t j = intersectIndex; j < verticesSorted[i + 1].second.size(); j++)
-					vertices[verticesSorted[i].first].push_back(verticesSorted[i + 1].second[j]);
-
-				vertices.erase(verticesSorted[i + 1].first);
-				verticesSorted.erase(verticesSorted.begin() + i + 1);
-
-				i--;
-			}
-		}
-
 		// Generate Vertex Declarations
 		std::vector<int32_t> vtxKeys;
 		vtxKeys.reserve(vertices.size());
@@ -2093,69 +2141,623 @@ std::string ZDisplayList::ProcessGfxDis([[maybe_unused]] const std::string& pref
 {
 	std::string sourceOutput;
 
-	OutputFormatter outputformatter;
-	int32_t dListSize = instructions.size() * sizeof(instructions[0]);
+	// The callbacks name matrices and such after this display list, so the result can only be
+	// reused by a display list with the same name
+	DListCacheEntry* cacheEntry = nullptr;
+	auto cached = parent->dListCache.find({rawDataIndex, static_cast<int>(dListType)});
+	if (cached != parent->dListCache.end() &&
+	    cached->second->instructions.size() == instructions.size())
+		cacheEntry = cached->second.get();
 
-	gfxd_input_buffer(instructions.data(), dListSize);
-	gfxd_endian(gfxd_endian_little, sizeof(uint64_t));  // tell gfxdis what format the data is
+	dListGfxdCount.fetch_add(1, std::memory_order_relaxed);
+	if (cacheEntry != nullptr && cacheEntry->processed && cacheEntry->name == name)
+	{
+		dListGfxdHits.fetch_add(1, std::memory_order_relaxed);
 
-	gfxd_macro_fn(GfxdCallback_FormatSingleEntry);  // format for each command entry
-	gfxd_vtx_callback(GfxdCallback_Vtx);            // handle vertices
-	gfxd_timg_callback(GfxdCallback_Texture);       // handle textures
-	gfxd_tlut_callback(GfxdCallback_Palette);       // handle palettes
-	gfxd_dl_callback(GfxdCallback_DisplayList);     // handle child display lists
-	gfxd_mtx_callback(GfxdCallback_Matrix);         // handle matrices
-	gfxd_output_callback(
-		outputformatter.StaticWriter());  // convert tabs to 4 spaces and enforce 120 line limit
+		vertices = cacheEntry->vertices;
+		mtxList = cacheEntry->mtxList;
+		references.insert(references.end(), cacheEntry->references.begin(),
+		                  cacheEntry->references.end());
+		for (const auto& child : cacheEntry->childDLists)
+		{
+			ZDisplayList* childDList = new ZDisplayList(parent);
+			childDList->ExtractFromBinary(child.first, dListType);
+			childDList->SetName(child.second);
+			otherDLists.push_back(childDList);
+		}
 
-	gfxd_enable(gfxd_emit_dec_color);  // use decimal for colors
+		return cacheEntry->sourceOutput;
+	}
 
-	// set microcode. see gfxd.h for more options.
-	if (dListType == DListType::F3DZEX)
-		gfxd_target(gfxd_f3dex2);
+	size_t firstChild = otherDLists.size();
+	size_t firstReference = references.size();
+
+	// Without text to output, the references found by the scan are all gfxd would provide.
+	// Textures still need gfxd to work out their dimensions from the load commands
+	if (Globals::Instance->binaryOnly && cacheEntry != nullptr &&
+	    !cacheEntry->scan.needsGfxd && !cacheEntry->scan.loadsTextures)
+	{
+		for (const auto& ref : cacheEntry->scan.references)
+		{
+			switch (ref.type)
+			{
+			case DListReferenceType::Vertex:
+				AddVtxReference(this, ref.address, ref.count);
+				break;
+			case DListReferenceType::Matrix:
+				AddMtxReference(this, ref.address);
+				break;
+			case DListReferenceType::DisplayList:
+				AddDListReference(this, ref.address);
+				break;
+			}
+		}
+	}
 	else
-		gfxd_target(gfxd_f3dex);
+	{
+		OutputFormatter outputformatter;
+		int32_t dListSize = instructions.size() * sizeof(instructions[0]);
+
+		gfxd_input_buffer(instructions.data(), dListSize);
+		gfxd_endian(gfxd_endian_little, sizeof(uint64_t));  // tell gfxdis what format the data is
 
-	gfxd_udata_set(this);
-	gfxd_execute();                               // generate display list
-	sourceOutput += outputformatter.GetOutput();  // write formatted display list
+		gfxd_macro_fn(GfxdCallback_FormatSingleEntry);  // format for each command entry
+		gfxd_vtx_callback(GfxdCallback_Vtx);            // handle vertices
+		gfxd_timg_callback(GfxdCallback_Texture);       // handle textures
+		gfxd_tlut_callback(GfxdCallback_Palette);       // handle palettes
+		gfxd_dl_callback(GfxdCallback_DisplayList);     // handle child display lists
+		gfxd_mtx_callback(GfxdCallback_Matrix);         // handle matrices
+
+		if (Globals::Instance->binaryOnly)
+			gfxd_output_callback(GfxdCallback_DiscardOutput);
+		else  // convert tabs to 4 spaces and enforce 120 line limit
+			gfxd_output_callback(outputformatter.StaticWriter());
+
+		gfxd_enable(gfxd_emit_dec_color);  // use decimal for colors
+
+		// set microcode. see gfxd.h for more options.
+		if (dListType == DListType::F3DZEX)
+			gfxd_target(gfxd_f3dex2);
+		else
+			gfxd_target(gfxd_f3dex);
+
+		gfxd_udata_set(this);
+		gfxd_execute();                               // generate display list
+		sourceOutput += outputformatter.GetOutput();  // write formatted display list
+	}
 
 	MergeConnectingVertexLists();
 
+	if (cacheEntry != nullptr && !cacheEntry->processed)
+	{
+		cacheEntry->processed = true;
+		cacheEntry->name = name;
+		cacheEntry->sourceOutput = sourceOutput;
+		cacheEntry->vertices = vertices;
+		cacheEntry->mtxList = mtxList;
+		cacheEntry->references.assign(references.begin() + firstReference, references.end());
+		for (size_t i = firstChild; i < otherDLists.size(); i++)
+			cacheEntry->childDLists.push_back(
+				{otherDLists[i]->GetRawDataIndex(), otherDLists[i]->GetName()});
+	}
+
 	return sourceOutput;
 }
 
-void ZDisplayList::MergeConnectingVertexLists()
+// Finds the declaration of `file` which contains `offset`
+static const Declaration* FindContainingDeclaration(const ZFile* file, offset_t offset)
 {
-	if (vertices.size() > 0)
+	auto it = file->declarations.upper_bound(offset);
+	if (it == file->declarations.begin())
+		return nullptr;
+
+	--it;
+	if (offset < it->first + it->second->size)
+		return it->second;
+
+	return nullptr;
+}
+
+DListBinary ZDisplayList::LowerToBinary() const
+{
+	// Copied once, GetSegmentRefFiles returns the index by value
+	std::map<int32_t, std::vector<ZFile*>> segmentFiles;
+	bool segmentFilesLoaded = false;
+
+	auto resolve = [&](segptr_t address, std::string& path, uint32_t& offset) {
+		const ZFile* file = nullptr;
+		const Declaration* decl = nullptr;
+		uint32_t segment = GETSEGNUM(address);
+
+		if (segment == parent->segment || parent->IsSegmentedInFilespaceRange(address))
+		{
+			file = parent;
+			decl = FindContainingDeclaration(file, Seg2Filespace(address, file->baseAddress));
+		}
+		else
+		{
+			if (!segmentFilesLoaded)
+			{
+				segmentFiles = Globals::Instance->GetSegmentRefFiles(parent->workerID);
+				segmentFilesLoaded = true;
+			}
+
+			auto segmentIt = segmentFiles.find(segment);
+			if (segmentIt != segmentFiles.end())
+			{
+				for (const ZFile* segmentFile : segmentIt->second)
+				{
+					if (!segmentFile->IsSegmentedInFilespaceRange(address))
+						continue;
+
+					decl = FindContainingDeclaration(
+						segmentFile, Seg2Filespace(address, segmentFile->baseAddress));
+					if (decl != nullptr)
+					{
+						file = segmentFile;
+						break;
+					}
+				}
+			}
+		}
+
+		if (decl == nullptr)
+			return false;
+
+		path = file->GetOutName() + "/" + decl->declName;
+		offset = Seg2Filespace(address, file->baseAddress) - decl->address;
+		return true;
+	};
+
+	return LowerCommands(instructions, dListType, resolve);
+}
+
+DListBinary ZDisplayList::LowerCommands(
+	const std::vector<uint64_t>& commands, DListType dListType,
+	const std::function<bool(segptr_t address, std::string& path, uint32_t& offset)>& resolve)
+{
+	uint8_t vtxOpcode, dlOpcode, mtxOpcode, moveMemOpcode, setTImgOpcode;
+	uint8_t rdpHalf1Opcode, branchZOpcode;
+
+	if (dListType == DListType::F3DZEX)
 	{
-		std::vector<std::pair<uint32_t, std::vector<ZVtx>>> vertexKeys(vertices.begin(),
-		                                                               vertices.end());
-		std::pair<uint32_t, std::vector<ZVtx>> lastItem = vertexKeys.at(0);
+		vtxOpcode = static_cast<uint8_t>(F3DZEXOpcode::G_VTX);
+		dlOpcode = static_cast<uint8_t>(F3DZEXOpcode::G_DL);
+		mtxOpcode = static_cast<uint8_t>(F3DZEXOpcode::G_MTX);
+		moveMemOpcode = static_cast<uint8_t>(F3DZEXOpcode::G_MOVEMEM);
+		setTImgOpcode = static_cast<uint8_t>(F3DZEXOpcode::G_SETTIMG);
+		rdpHalf1Opcode = static_cast<uint8_t>(F3DZEXOpcode::G_RDPHALF_1);
+		branchZOpcode = static_cast<uint8_t>(F3DZEXOpcode::G_BRANCH_Z);
+	}
+	else
+	{
+		vtxOpcode = static_cast<uint8_t>(F3DEXOpcode::G_VTX);
+		dlOpcode = static_cast<uint8_t>(F3DEXOpcode::G_DL);
+		mtxOpcode = static_cast<uint8_t>(F3DEXOpcode::G_MTX);
+		moveMemOpcode = static_cast<uint8_t>(F3DEXOpcode::G_MOVEMEM);
+		setTImgOpcode = static_cast<uint8_t>(F3DEXOpcode::G_SETTIMG);
+		rdpHalf1Opcode = static_cast<uint8_t>(F3DEXOpcode::G_RDPHALF_1);
+		branchZOpcode = static_cast<uint8_t>(F3DEXOpcode::G_BRANCH_Z);
+	}
+
+	DListBinary result;
+	result.commands = commands;
 
-		for (size_t i = 1; i < vertexKeys.size(); i++)
+	std::map<std::string, uint32_t> pathIndices;
+	std::string path;
+	uint32_t offset;
+
+	for (size_t i = 0; i < result.commands.size(); i++)
+	{
+		uint64_t& command = result.commands[i];
+		uint8_t opcode = command >> 56;
+
+		bool hasAddress = opcode == vtxOpcode || opcode == dlOpcode || opcode == mtxOpcode ||
+		                  opcode == moveMemOpcode || opcode == setTImgOpcode;
+		if (opcode == rdpHalf1Opcode)
 		{
-			std::pair<uint32_t, std::vector<ZVtx>> curItem = vertexKeys[i];
+			// gsSPBranchLessZ keeps the branch target in the G_RDPHALF_1 command
+			hasAddress =
+				i + 1 < result.commands.size() && (result.commands[i + 1] >> 56) == branchZOpcode;
+		}
 
-			size_t lastItemEnd = lastItem.first + (lastItem.second.size() * 16);
-			bool lastItemIntersects = lastItemEnd >= curItem.first;
+		segptr_t address = command & 0xFFFFFFFF;
+		if (!hasAddress || address == SEGMENTED_NULL || !resolve(address, path, offset))
+			continue;
 
-			if (lastItemIntersects)
+		auto pathIt = pathIndices.find(path);
+		if (pathIt == pathIndices.end())
+		{
+			pathIt = pathIndices.emplace(path, result.resourcePaths.size()).first;
+			result.resourcePaths.push_back(path);
+		}
+
+		result.references.push_back({i, address, pathIt->second, offset});
+		command = (command & 0xFFFFFFFF00000000) | pathIt->second;
+	}
+
+	return result;
+}
+
+struct MeshStateEntry
+{
+	uint64_t key;  // The opcode in the high word, what the command applies to in the low word
+	std::vector<uint64_t> commands;
+};
+
+// The render state built by a display list, as far as the batches need to tell materials apart
+class MeshState
+{
+public:
+	uint32_t geometryMode = 0;
+	uint32_t otherModeH = 0;
+	uint32_t otherModeL = 0;
+	uint32_t barrierCount = 0;  // Makes state changes which can't be replaced unique
+	uint64_t tImg = 0;
+	uint64_t tiles[8] = {};
+
+	void Set(uint8_t opcode, uint32_t target, std::vector<uint64_t> commands)
+	{
+		uint64_t key = (static_cast<uint64_t>(opcode) << 32) | target;
+
+		for (auto it = entries.begin(); it != entries.end(); ++it)
+		{
+			if (it->key == key)
 			{
-				int intersectedVtxStart = (lastItemEnd - curItem.first) / 16;
+				entries.erase(it);
+				break;
+			}
+		}
+
+		entries.push_back({key, std::move(commands)});
+	}
+
+	std::vector<uint64_t> Snapshot(DListType type) const
+	{
+		std::vector<uint64_t> state;
+
+		state.push_back((static_cast<uint64_t>(F3DZEXOpcode::G_RDPSETOTHERMODE) << 56) |
+		                (static_cast<uint64_t>(otherModeH & 0xFFFFFF) << 32) | otherModeL);
+		if (type == DListType::F3DZEX)
+		{
+			// Keep no bits, then set the whole mode
+			state.push_back((static_cast<uint64_t>(F3DZEXOpcode::G_GEOMETRYMODE) << 56) |
+			                geometryMode);
+		}
+		else
+		{
+			state.push_back((static_cast<uint64_t>(F3DEXOpcode::G_CLEARGEOMETRYMODE) << 56) |
+			                0xFFFFFFFF);
+			state.push_back((static_cast<uint64_t>(F3DEXOpcode::G_SETGEOMETRYMODE) << 56) |
+			                geometryMode);
+		}
+
+		for (const auto& entry : entries)
+			state.insert(state.end(), entry.commands.begin(), entry.commands.end());
+
+		return state;
+	}
+
+private:
+	std::vector<MeshStateEntry> entries;
+};
+
+bool ZDisplayList::BuildMeshBatches(std::vector<DListMeshBatch>& batches) const
+{
+	const bool isF3DZEX = dListType == DListType::F3DZEX;
+	const auto& rawData = parent->GetRawData();
+
+	// Microcode commands differ between the two, RDP commands are shared
+	auto op = [isF3DZEX](F3DZEXOpcode f3dzex, F3DEXOpcode f3dex) {
+		return isF3DZEX ? static_cast<uint8_t>(f3dzex) : static_cast<uint8_t>(f3dex);
+	};
+	auto rdp = [](F3DZEXOpcode opcode) { return static_cast<uint8_t>(opcode); };
+
+	MeshState state;
+	std::map<std::vector<uint64_t>, size_t> batchIndices;
+	// Per batch, the index of each vertex by its segmented address
+	std::vector<std::map<segptr_t, uint16_t>> batchVertices;
+	segptr_t vtxCache[64];
+	std::fill(std::begin(vtxCache), std::end(vtxCache), SEGMENTED_NULL);
+
+	size_t curBatch = SIZE_MAX;
+	auto addTriangle = [&](uint32_t i0, uint32_t i1, uint32_t i2) {
+		if (i0 >= 64 || i1 >= 64 || i2 >= 64)
+			return false;
+
+		segptr_t addresses[3] = {vtxCache[i0], vtxCache[i1], vtxCache[i2]};
+		for (segptr_t address : addresses)
+		{
+			if (address == SEGMENTED_NULL)
+				return false;
+		}
+
+		if (curBatch == SIZE_MAX || batches[curBatch].vertices.size() + 3 > UINT16_MAX)
+		{
+			std::vector<uint64_t> snapshot = state.Snapshot(dListType);
+			auto found = batchIndices.find(snapshot);
+
+			if (found != batchIndices.end() &&
+			    batches[found->second].vertices.size() + 3 <= UINT16_MAX)
+				curBatch = found->second;
+			else
+			{
+				curBatch = batches.size();
+				batches.push_back({snapshot, {}, {}});
+				batchVertices.emplace_back();
+				batchIndices[snapshot] = curBatch;
+			}
+		}
+
+		DListMeshBatch& batch = batches[curBatch];
+		for (segptr_t address : addresses)
+		{
+			auto vtx = batchVertices[curBatch].find(address);
+			if (vtx == batchVertices[curBatch].end())
+			{
+				offset_t offset = Seg2Filespace(address, parent->baseAddress);
+				if (!parent->IsSegmentedInFilespaceRange(address) ||
+				    offset + 16 > rawData.size())
+					return false;
+
+				vtx = batchVertices[curBatch].emplace(address, batch.vertices.size()).first;
+				VtxData::ParseList(rawData, offset, 1, batch.vertices);
+			}
+
+			batch.indices.push_back(vtx->second);
+		}
+
+		return true;
+	};
+
+	auto stateChanged = [&]() { curBatch = SIZE_MAX; };
+
+	// Call stack of display lists, RSP microcodes allow 10 to 18 levels
+	struct MeshFrame
+	{
+		const std::vector<uint64_t>* commands;
+		size_t next;
+		// The lists entered at this level so far: the called one, then every branch target
+		std::set<offset_t> branchChain;
+	};
+	std::vector<MeshFrame> stack;
+	stack.push_back({&instructions, 0, {rawDataIndex}});
+	batches.clear();
+
+	while (!stack.empty())
+	{
+		MeshFrame& frame = stack.back();
+		if (frame.next >= frame.commands->size())
+		{
+			stack.pop_back();
+			continue;
+		}
+
+		uint64_t data = (*frame.commands)[frame.next++];
+		uint8_t opcode = data >> 56;
+		uint32_t w0 = data >> 32;
+		uint32_t w1 = data & 0xFFFFFFFF;
+
+		if (opcode == op(F3DZEXOpcode::G_VTX, F3DEXOpcode::G_VTX))
+		{
+			uint32_t n = isF3DZEX ? (w0 >> 12) & 0xFF : (w0 >> 10) & 0x3F;
+			int32_t v0 = isF3DZEX ? static_cast<int32_t>(((w0 >> 1) & 0x7F) - n) :
+			                        static_cast<int32_t>((w0 >> 16) & 0xFF) / 2;
+
+			if (v0 < 0 || v0 + n > 64)
+				return false;
+
+			for (uint32_t i = 0; i < n; i++)
+				vtxCache[v0 + i] = w1 + i * 16;
+		}
+		else if (opcode == op(F3DZEXOpcode::G_TRI1, F3DEXOpcode::G_TRI1))
+		{
+			uint32_t tri = isF3DZEX ? w0 : w1;
+			if (!addTriangle(((tri >> 16) & 0xFF) / 2, ((tri >> 8) & 0xFF) / 2, (tri & 0xFF) / 2))
+				return false;
+		}
+		// gsSP1Quadrangle is encoded as two triangles, (v0, v1, v2) and (v0, v2, v3): F3DEX uses
+		// G_TRI2 for it, F3DZEX either G_TRI2 or G_QUAD with the same layout
+		else if (opcode == op(F3DZEXOpcode::G_TRI2, F3DEXOpcode::G_TRI2) ||
+		         (isF3DZEX && opcode == static_cast<uint8_t>(F3DZEXOpcode::G_QUAD)))
+		{
+			if (!addTriangle(((w0 >> 16) & 0xFF) / 2, ((w0 >> 8) & 0xFF) / 2, (w0 & 0xFF) / 2) ||
+			    !addTriangle(((w1 >> 16) & 0xFF) / 2, ((w1 >> 8) & 0xFF) / 2, (w1 & 0xFF) / 2))
+				return false;
+		}
+		else if (opcode == op(F3DZEXOpcode::G_DL, F3DEXOpcode::G_DL))
+		{
+			bool noPush = ((w0 >> 16) & 0xFF) == 1;
+			std::set<offset_t> branchChain;
 
-				for (size_t j = intersectedVtxStart; j < curItem.second.size(); j++)
-					vertices[lastItem.first].push_back(curItem.second[j]);
+			if (noPush)
+			{
+				branchChain = std::move(frame.branchChain);
+				stack.pop_back();
+			}
 
-				vertices.erase(curItem.first);
-				vertexKeys.erase(vertexKeys.begin() + i);
+			if (parent->IsSegmentedInFilespaceRange(w1))
+			{
+				offset_t target = Seg2Filespace(w1, parent->baseAddress);
 
-				lastItem.second = vertices[lastItem.first];
+				// A branch doesn't grow the stack, so a chain of branches back into itself would
+				// replay forever at the same depth
+				if (!branchChain.insert(target).second || stack.size() >= 18)
+					return false;
 
-				i--;
+				const DListCacheEntry& child = GetDListCacheEntry(parent, target, dListType);
+				stack.push_back({&child.instructions, 0, std::move(branchChain)});
 			}
 			else
-				lastItem = curItem;
+			{
+				// Whatever the list sets is unknown, so nothing after it can share a batch with
+				// what came before
+				state.Set(opcode, state.barrierCount++, {data});
+				stateChanged();
+			}
+		}
+		else if (opcode == op(F3DZEXOpcode::G_ENDDL, F3DEXOpcode::G_ENDDL))
+			stack.pop_back();
+		else if (isF3DZEX && opcode == static_cast<uint8_t>(F3DZEXOpcode::G_GEOMETRYMODE))
+		{
+			state.geometryMode = (state.geometryMode & (w0 & 0xFFFFFF)) | w1;
+			stateChanged();
+		}
+		else if (!isF3DZEX && opcode == static_cast<uint8_t>(F3DEXOpcode::G_SETGEOMETRYMODE))
+		{
+			state.geometryMode |= w1;
+			stateChanged();
+		}
+		else if (!isF3DZEX && opcode == static_cast<uint8_t>(F3DEXOpcode::G_CLEARGEOMETRYMODE))
+		{
+			state.geometryMode &= ~w1;
+			stateChanged();
+		}
+		else if (opcode == op(F3DZEXOpcode::G_SETOTHERMODE_H, F3DEXOpcode::G_SETOTHERMODE_H) ||
+		         opcode == op(F3DZEXOpcode::G_SETOTHERMODE_L, F3DEXOpcode::G_SETOTHERMODE_L))
+		{
+			uint32_t len = isF3DZEX ? (w0 & 0xFF) + 1 : w0 & 0xFF;
+			uint32_t shift = isF3DZEX ? 32 - ((w0 >> 8) & 0xFF) - len : (w0 >> 8) & 0xFF;
+			uint32_t mask = static_cast<uint32_t>(((1ULL << len) - 1) << shift);
+			bool isHigh =
+				opcode == op(F3DZEXOpcode::G_SETOTHERMODE_H, F3DEXOpcode::G_SETOTHERMODE_H);
+			uint32_t& mode = isHigh ? state.otherModeH : state.otherModeL;
+
+			mode = (mode & ~mask) | (w1 & mask);
+			stateChanged();
+		}
+		else if (opcode == rdp(F3DZEXOpcode::G_RDPSETOTHERMODE))
+		{
+			state.otherModeH = w0 & 0xFFFFFF;
+			state.otherModeL = w1;
+			stateChanged();
+		}
+		else if (opcode == rdp(F3DZEXOpcode::G_SETTIMG))
+		{
+			state.tImg = data;
+			state.Set(opcode, 0, {data});
+			stateChanged();
+		}
+		else if (opcode == rdp(F3DZEXOpcode::G_SETTILE) ||
+		         opcode == rdp(F3DZEXOpcode::G_SETTILESIZE))
+		{
+			uint32_t tile = (w1 >> 24) & 7;
+
+			if (opcode == rdp(F3DZEXOpcode::G_SETTILE))
+				state.tiles[tile] = data;
+			state.Set(opcode, tile, {data});
+			stateChanged();
+		}
+		else if (opcode == rdp(F3DZEXOpcode::G_LOADBLOCK) ||
+		         opcode == rdp(F3DZEXOpcode::G_LOADTILE) ||
+		         opcode == rdp(F3DZEXOpcode::G_LOADTLUT))
+		{
+			// A load replaces whatever was in TMEM at its tile's address before
+			uint64_t tile = state.tiles[(w1 >> 24) & 7];
+			uint32_t tmem = (tile >> 32) & 0x1FF;
+
+			state.Set(rdp(F3DZEXOpcode::G_LOADBLOCK), tmem, {state.tImg, tile, data});
+			stateChanged();
+		}
+		else if (opcode == op(F3DZEXOpcode::G_MTX, F3DEXOpcode::G_MTX) ||
+		         opcode == op(F3DZEXOpcode::G_POPMTX, F3DEXOpcode::G_POPMTX) ||
+		         opcode == op(F3DZEXOpcode::G_MOVEMEM, F3DEXOpcode::G_MOVEMEM))
+		{
+			// Matrix stack operations and lights build on the previous ones
+			state.Set(opcode, state.barrierCount++, {data});
+			stateChanged();
+		}
+		else if (opcode == op(F3DZEXOpcode::G_NOOP, F3DEXOpcode::G_NOOP) ||
+		         opcode == op(F3DZEXOpcode::G_SPNOOP, F3DEXOpcode::G_SPNOOP) ||
+		         opcode == op(F3DZEXOpcode::G_CULLDL, F3DEXOpcode::G_CULLDL) ||
+		         opcode == rdp(F3DZEXOpcode::G_RDPLOADSYNC) ||
+		         opcode == rdp(F3DZEXOpcode::G_RDPPIPESYNC) ||
+		         opcode == rdp(F3DZEXOpcode::G_RDPTILESYNC) ||
+		         opcode == rdp(F3DZEXOpcode::G_RDPFULLSYNC))
+		{
+			// Culling only skips work, and syncs only matter to the RDP
+		}
+		else if (!isF3DZEX && opcode == static_cast<uint8_t>(F3DEXOpcode::G_QUAD))
+		{
+			// Neither gfxd nor the legacy decoder know this F3DEX opcode, so which triangles it
+			// draws is unknown
+			return false;
+		}
+		else if (opcode == op(F3DZEXOpcode::G_MODIFYVTX, F3DEXOpcode::G_MODIFYVTX) ||
+		         opcode == op(F3DZEXOpcode::G_BRANCH_Z, F3DEXOpcode::G_BRANCH_Z) ||
+		         opcode == op(F3DZEXOpcode::G_LOAD_UCODE, F3DEXOpcode::G_LOAD_UCODE) ||
+		         opcode == rdp(F3DZEXOpcode::G_TEXRECT) ||
+		         opcode == rdp(F3DZEXOpcode::G_TEXRECTFLIP) ||
+		         opcode == rdp(F3DZEXOpcode::G_FILLRECT) ||
+		         opcode == op(F3DZEXOpcode::G_RDPHALF_1, F3DEXOpcode::G_RDPHALF_1))
+			return false;
+		else if (opcode == op(F3DZEXOpcode::G_MOVEWORD, F3DEXOpcode::G_MOVEWORD))
+		{
+			// Segments, fog and such, keyed by the index and offset they write
+			state.Set(opcode, w0 & 0xFFFFFF, {data});
+			stateChanged();
+		}
+		else
+		{
+			// Colors, combiner and the like, only the latest one matters
+			state.Set(opcode, 0, {data});
+			stateChanged();
+		}
+	}
+
+	return true;
+}
+
+void ZDisplayList::PrintCacheReport()
+{
+	uint64_t decodeCount = dListDecodeCount.load(std::memory_order_relaxed);
+	uint64_t gfxdCount = dListGfxdCount.load(std::memory_order_relaxed);
+
+	if (decodeCount == 0 && gfxdCount == 0)
+		return;
+
+	printf("DisplayList cache: %" PRIu64 "/%" PRIu64 " decodes reused, %" PRIu64 "/%" PRIu64
+	       " gfxd passes reused\n",
+	       dListDecodeHits.load(std::memory_order_relaxed), decodeCount,
+	       dListGfxdHits.load(std::memory_order_relaxed), gfxdCount);
+}
+
+void ZDisplayList::MergeConnectingVertexLists()
+{
+	MergeVertexLists(vertices, true);
+}
+
+void ZDisplayList::MergeVertexLists(std::map<uint32_t, std::vector<VtxData>>& lists,
+                                    bool mergeTouching)
+{
+	if (lists.empty())
+		return;
+
+	// The map is sorted by offset, so each list only needs to be checked against the list that
+	// is being built before it
+	auto cur = lists.begin();
+	auto next = std::next(cur);
+
+	while (next != lists.end())
+	{
+		size_t curEnd = cur->first + cur->second.size() * 16;
+		bool intersects = mergeTouching ? curEnd >= next->first : curEnd > next->first;
+
+		if (intersects)
+		{
+			size_t intersectedVtxStart = (curEnd - next->first) / 16;
+
+			if (intersectedVtxStart < next->second.size())
+				cur->second.insert(cur->second.end(),
+				                   next->second.begin() + intersectedVtxStart,
+				                   next->second.end());
+
+			next = lists.erase(next);
+		}
+		else
+		{
+			cur = next;
+			++next;
 		}
 	}
 }
@@ -2302,6 +2904,11 @@ std::string ZDisplayList::GetSourceTypeName() const
 	return "Gfx";
 }
 
+bool ZDisplayList::HasBodySourceCode() const
+{
+	return false;
+}
+
 ZResourceType ZDisplayList::GetResourceType() const
 {
 	return ZResourceType::DisplayList;
@@ -7,6 +7,7 @@
 #include "ZVtx.h"
 #include "tinyxml2.h"
 
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
@@ -145,6 +146,83 @@ enum class DListType
 	F3DEX,
 };
 
+enum class DListReferenceType
+{
+	Vertex,
+	Matrix,
+	DisplayList,
+};
+
+struct DListReference
+{
+	DListReferenceType type;
+	segptr_t address;
+	int32_t count;  // Number of vertices loaded, for vertex references
+};
+
+/**
+ * The result of reading a display list's big-endian command stream once
+ */
+struct DListScan
+{
+	size_t length = 0;  // In bytes, including the command which ends the list
+	std::vector<DListReference> references;  // In command order
+	bool loadsTextures = false;              // Has G_SETTIMG or G_LOADTLUT commands
+	// Has commands whose references only gfxd can resolve (i.e. F3DEX lists, G_MOVEMEM)
+	bool needsGfxd = false;
+};
+
+struct DListBinaryReference
+{
+	size_t commandIndex;  // The command whose address was rewritten
+	segptr_t address;     // The original segmented address
+	uint32_t pathIndex;   // Into DListBinary::resourcePaths
+	uint32_t offset;      // From the start of the resource, i.e. a vertex inside an array
+};
+
+/**
+ * A display list lowered for binary exporters.
+ * Every address that resolves to a declaration is replaced with the index of the resource's path
+ * ("<file out name>/<declaration name>"). Unresolved addresses are left as they are.
+ */
+struct DListBinary
+{
+	std::vector<uint64_t> commands;
+	std::vector<std::string> resourcePaths;
+	std::vector<DListBinaryReference> references;  // In command order
+};
+
+/**
+ * Triangles drawn under the same material state, as an indexed mesh.
+ * `state` lists the commands which rebuild that state: a G_RDPSETOTHERMODE and geometry mode
+ * command, then the latest command of every other kind in the order they were issued. Texture
+ * loads keep the G_SETTIMG and G_SETTILE they used, one load per TMEM address.
+ */
+struct DListMeshBatch
+{
+	std::vector<uint64_t> state;
+	std::vector<VtxData> vertices;
+	std::vector<uint16_t> indices;  // Three per triangle
+};
+
+/**
+ * A display list as seen by the first reference to it in a file. Later references reuse the
+ * decoded instructions and, if their name matches, the result of the gfxd pass.
+ */
+struct DListCacheEntry
+{
+	std::vector<uint64_t> instructions;
+	DListScan scan;
+
+	bool processed = false;
+	std::string name;
+	std::string sourceOutput;
+	std::map<uint32_t, std::vector<VtxData>> vertices;
+	std::vector<ZMtx> mtxList;
+	std::vector<std::pair<uint32_t, std::string>> childDLists;  // Offset and name
+	std::vector<segptr_t> references;  // Resolve the "@r" placeholders of `sourceOutput`
+};
+
 enum class OoTSegments
 {
 	DirectReference = 0,
@@ -218,7 +296,7 @@ public:
 
 	DListType dListType;
 
-	std::map<uint32_t, std::vector<ZVtx>> vertices;
+	std::map<uint32_t, std::vector<VtxData>> vertices;
 	std::vector<ZDisplayList*> otherDLists;
 
 	ZTexture* lastTexture = nullptr;
@@ -232,6 +310,9 @@ public:
 
 	void ExtractWithXML(tinyxml2::XMLElement* reader, uint32_t nRawDataIndex) override;
 	void ExtractFromBinary(uint32_t nRawDataIndex, int32_t rawDataSize);
+	// Looks for the end of the display list using `scanType`, sharing the decode with earlier
+	// references to the same offset
+	void ExtractFromBinary(uint32_t nRawDataIndex, DListType scanType);
 
 	void ParseRawData() override;
 
@@ -244,6 +325,10 @@ public:
 	                            bool texLoaded, bool texIsPalette, ZDisplayList* self);
 	static int32_t GetDListLength(const std::vector<uint8_t>& rawData, uint32_t rawDataIndex,
 	                              DListType dListType);
+	// Finds the end of the display list and the resources it references in a single pass. If
+	// `instructions` isn't null, the commands are also decoded into it
+	static DListScan ScanDList(const std::vector<uint8_t>& rawData, uint32_t rawDataIndex,
+	                           DListType dListType, std::vector<uint64_t>* instructions = nullptr);
 
 	size_t GetRawDataSize() const override;
 	DeclarationAlignment GetDeclarationAlignment() const override;
@@ -251,13 +336,42 @@ public:
 	std::string ProcessLegacy(const std::string& prefix);
 	std::string ProcessGfxDis(const std::string& prefix);
 
+	// Resolves the addresses in `instructions` through the segment index, with no text output
+	DListBinary LowerToBinary() const;
+	/**
+	 * The command rewriting behind LowerToBinary. `resolve` is called for each address and
+	 * returns false if no resource contains it, otherwise it sets the resource's path and the
+	 * offset of the address into it.
+	 */
+	static DListBinary LowerCommands(
+		const std::vector<uint64_t>& commands, DListType dListType,
+		const std::function<bool(segptr_t address, std::string& path, uint32_t& offset)>& resolve);
+	/**
+	 * Replays the display list, and the ones it calls from the same file, through a simulated
+	 * vertex cache, grouping its triangles by material state. Returns false if the list can't be
+	 * drawn as plain meshes (i.e. it modifies vertices, branches on depth, draws rectangles or
+	 * branches in a loop).
+	 */
+	bool BuildMeshBatches(std::vector<DListMeshBatch>& batches) const;
+
+	// Prints how often display list decodes and gfxd passes were reused
+	static void PrintCacheReport();
+
 	// Combines vertex lists from the vertices map which touch or intersect
 	void MergeConnectingVertexLists();
+	/**
+	 * Appends each list of `lists` which intersects the one before it to that list, in a single
+	 * pass over the offsets. Lists which only touch are combined if `mergeTouching` is set.
+	 * Lists nested in the one before them are dropped.
+	 */
+	static void MergeVertexLists(std::map<uint32_t, std::vector<VtxData>>& lists,
+	                             bool mergeTouching);
 
 	bool IsExternalResource() const override;
 	std::string GetExternalExtension() const override;
 	std::string GetSourceTypeName() const override;
 
+	bool HasBodySourceCode() const override;
 	ZResourceType GetResourceType() const override;
 
 protected:
@@ -6,6 +6,7 @@
 #include <unordered_set>
 
 #include "Globals.h"
+#include "MemoryStats.h"
 #include "OutputFormatter.h"
 #include "Utils/BinaryWriter.h"
 #include "Utils/BitConverter.h"
@@ -131,6 +132,9 @@ void ZFile::ParseXML(tinyxml2::XMLElement* reader, const std::string& filename)
 	if (reader->Attribute("Compilable") != nullptr)
 		isCompilable = true;
 
+	if (reader->Attribute("RGBA8Textures") != nullptr)
+		rgba8Textures = true;
+
 	if (rangeStart > rangeEnd)
 		HANDLE_ERROR_PROCESS(
 			WarningType::Always,
@@ -280,7 +284,12 @@ void ZFile::ParseXML(tinyxml2::XMLElement* reader, const std::string& filename)
 
 		if (nodeMap.find(nodeName) != nodeMap.end())
 		{
-			ZResource* nRes = nodeMap[nodeName](this);
+			ZResource* nRes;
+			{
+				MemoryStatsScope memScope(MemoryPhase::Construct);
+				nRes = nodeMap[nodeName](this);
+				memScope.SetResourceType(nRes->GetResourceType());
+			}
 
 			if (mode == ZFileMode::Extract || mode == ZFileMode::ExternalFile ||
 			    mode == ZFileMode::ExtractDirectory)
@@ -375,9 +384,15 @@ void ZFile::ExtractResources()
 		Directory::CreateDirectory(GetSourceOutputFolderPath().string());
 
 	for (size_t i = 0; i < resources.size(); i++)
+	{
+		MemoryStatsScope memScope(MemoryPhase::ParseRawData, resources[i]->GetResourceType());
 		resources[i]->ParseRawDataLate();
+	}
 	for (size_t i = 0; i < resources.size(); i++)
+	{
+		MemoryStatsScope memScope(MemoryPhase::Declare, resources[i]->GetResourceType());
 		resources[i]->DeclareReferencesLate(name);
+	}
 
 	if (Globals::Instance->genSourceFile)
 		GenerateSourceFiles();
@@ -395,6 +410,7 @@ void ZFile::ExtractResources()
 	for (ZResource* res : resources)
 	{
 		auto start = std::chrono::steady_clock::now();
+		MemoryStatsScope memScope(MemoryPhase::Export, res->GetResourceType());
 
 		auto memStreamRes = std::shared_ptr<MemoryStream>(new MemoryStream());
 		BinaryWriter writerRes = BinaryWriter(memStreamRes);
@@ -815,6 +831,22 @@ size_t ZFile::GetDeclarationSizeFromNeighbor(uint32_t declarationAddress)
 
 void ZFile::GenerateSourceFiles()
 {
+	// The exporters only need the declarations, not the text built from them
+	if (Globals::Instance->binaryOnly)
+	{
+		GeneratePlaceholderDeclarations();
+
+		for (ZResource* res : resources)
+		{
+			MemoryStatsScope memScope(MemoryPhase::GenerateSource, res->GetResourceType());
+			res->GetSourceOutputCode(name);
+		}
+
+		MemoryStatsScope memScope(MemoryPhase::GenerateSource);
+		FinalizeDeclarations();
+		return;
+	}
+
 	std::string sourceOutput;
 
 	sourceOutput += "#include \"ultra64.h\"\n";
@@ -847,10 +879,14 @@ void ZFile::GenerateSourceFiles()
 	for (size_t i = 0; i < resources.size(); i++)
 	{
 		ZResource* res = resources.at(i);
+		MemoryStatsScope memScope(MemoryPhase::GenerateSource, res->GetResourceType());
 		res->GetSourceOutputCode(name);
 	}
 
-	sourceOutput += ProcessDeclarations();
+	{
+		MemoryStatsScope memScope(MemoryPhase::GenerateSource);
+		sourceOutput += ProcessDeclarations();
+	}
 
 	fs::path outPath = GetSourceOutputFolderPath() / outName.stem().concat(".c");
 
@@ -1078,12 +1114,14 @@ void ZFile::RegisterNode(std::string nodeName, ZResourceFactoryFunc* nodeFunc)
 	(*nodeMap)[nodeName] = nodeFunc;
 }
 
-std::string ZFile::ProcessDeclarations()
+/**
+ * Resolves texture overlaps, merges neighboring arrays and pads the declarations.
+ * This changes what gets exported, so it has to run even when no source is written.
+ */
+void ZFile::FinalizeDeclarations()
 {
-	std::string output;
-
 	if (declarations.size() == 0)
-		return output;
+		return;
 
 	defines += ProcessTextureIntersections(name);
 
@@ -1091,8 +1129,12 @@ std::string ZFile::ProcessDeclarations()
 
 	MergeNeighboringDeclarations();
 
-	for (std::pair<uint32_t, Declaration*> item : declarations)
-		ProcessDeclarationText(item.second);
+	// Binary-only runs don't emit any `@r` reference to resolve
+	if (!Globals::Instance->binaryOnly)
+	{
+		for (std::pair<uint32_t, Declaration*> item : declarations)
+			ProcessDeclarationText(item.second);
+	}
 
 	for (std::pair<uint32_t, Declaration*> item : declarations)
 	{
@@ -1101,6 +1143,16 @@ std::string ZFile::ProcessDeclarations()
 	}
 
 	HandleUnaccountedData();
+}
+
+std::string ZFile::ProcessDeclarations()
+{
+	std::string output;
+
+	if (declarations.size() == 0)
+		return output;
+
+	FinalizeDeclarations();
 
 	// Go through include declarations
 	// First, handle the prototypes (static only for now)
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -7,6 +9,8 @@
 #include "ZTexture.h"
 #include "tinyxml2.h"
 
+struct DListCacheEntry;
+
 enum class ZFileMode
 {
 	BuildTexture,
@@ -17,6 +21,7 @@ enum class ZFileMode
 	Extract,
 	ExternalFile,
 	ExtractDirectory,
+	BuildBatch,
 	Invalid,
 	Custom = 1000,  // Used for exporter file modes
 };
@@ -44,6 +49,10 @@ public:
 	bool isExternalFile = false;
 	// Whether to make defines for texture dimensions, and possibly more in future
 	bool makeDefines = false;
+	// Whether the exporters should write this file's textures pre-decoded to RGBA8
+	bool rgba8Textures = false;
+	// Display lists decoded so far, keyed by offset and DListType
+	std::map<std::pair<offset_t, int>, std::unique_ptr<DListCacheEntry>> dListCache;
 
 	ZFile(const fs::path& nOutPath, const std::string& nName);
 	ZFile(ZFileMode nMode, tinyxml2::XMLElement* reader, const fs::path& nBasePath,
@@ -137,6 +146,7 @@ protected:
 	void GenerateSourceFiles();
 	void GenerateSourceHeaderFiles();
 	bool DeclarationSanityChecks(uint32_t address, const std::string& varName);
+	void FinalizeDeclarations();
 	std::string ProcessDeclarations();
 	void MergeNeighboringDeclarations();
 	void ProcessDeclarationText(Declaration* decl);
@@ -10,11 +10,15 @@
 
 REGISTER_ZFILENODE(Limb, ZLimb);
 
+static const ResourceAttributeSchema limbAttributes(&ZResource::commonAttributes, {
+	{"EnumName", false},
+	{"LimbType", false},
+	{"Type", false},
+});
+
 ZLimb::ZLimb(ZFile* nParent) : ZResource(nParent), segmentStruct(nParent)
 {
-	RegisterOptionalAttribute("EnumName");
-	RegisterOptionalAttribute("LimbType");
-	RegisterOptionalAttribute("Type");
+	attributeSchema = &limbAttributes;
 }
 
 void ZLimb::ExtractFromBinary(uint32_t nRawDataIndex, ZLimbType nType)
@@ -33,16 +37,16 @@ void ZLimb::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	auto& enumNameXml = registeredAttributes.at("EnumName").value;
+	auto& enumNameXml = GetAttribute("EnumName").value;
 	if (enumNameXml != "")
 	{
 		enumName = enumNameXml;
 	}
 
 	// Reading from a <Skeleton/>
-	std::string limbType = registeredAttributes.at("LimbType").value;
+	std::string limbType = GetAttribute("LimbType").value;
 	if (limbType == "")  // Reading from a <Limb/>
-		limbType = registeredAttributes.at("Type").value;
+		limbType = GetAttribute("Type").value;
 
 	if (limbType == "")
 	{
@@ -406,11 +410,10 @@ void ZLimb::DeclareDList(segptr_t dListSegmentedPtr, const std::string& prefix,
 	if (declFound)
 		return;
 
-	int32_t dlistLength = ZDisplayList::GetDListLength(
-		parent->GetRawData(), dlistOffset,
-		Globals::Instance->game == ZGame::OOT_SW97 ? DListType::F3DEX : DListType::F3DZEX);
 	ZDisplayList* dlist = new ZDisplayList(parent);
-	dlist->ExtractFromBinary(dlistOffset, dlistLength);
+	dlist->ExtractFromBinary(dlistOffset, Globals::Instance->game == ZGame::OOT_SW97 ?
+	                                          DListType::F3DEX :
+	                                          DListType::F3DZEX);
 
 	std::string dListStr =
 		StringHelper::Sprintf("%s%sDL_%06X", prefix.c_str(), limbSuffix.c_str(), dlistOffset);
@@ -9,17 +9,21 @@
 REGISTER_ZFILENODE(Path, ZPath);      // Old name that is being kept for backwards compatability
 REGISTER_ZFILENODE(PathList, ZPath);  // New name that may be used in future XMLs
 
+static const ResourceAttributeSchema pathAttributes(&ZResource::commonAttributes, {
+	{"NumPaths", false, "1"},
+});
+
 ZPath::ZPath(ZFile* nParent) : ZResource(nParent)
 {
 	numPaths = 1;
-	RegisterOptionalAttribute("NumPaths", "1");
+	attributeSchema = &pathAttributes;
 }
 
 void ZPath::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	numPaths = StringHelper::StrToL(registeredAttributes.at("NumPaths").value);
+	numPaths = StringHelper::StrToL(GetAttribute("NumPaths").value);
 
 	if (numPaths < 1)
 	{
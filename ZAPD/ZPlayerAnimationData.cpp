@@ -1,5 +1,7 @@
 #include "ZPlayerAnimationData.h"
 
+#include "BulkDecode.h"
+#include "SourceEmitter.h"
 #include "Utils/BitConverter.h"
 #include "Utils/StringHelper.h"
 #include "ZFile.h"
@@ -7,16 +9,20 @@
 
 REGISTER_ZFILENODE(PlayerAnimationData, ZPlayerAnimationData);
 
+static const ResourceAttributeSchema playerAnimationDataAttributes(&ZResource::commonAttributes, {
+	{"FrameCount", true},
+});
+
 ZPlayerAnimationData::ZPlayerAnimationData(ZFile* nParent) : ZResource(nParent)
 {
-	RegisterRequiredAttribute("FrameCount");
+	attributeSchema = &playerAnimationDataAttributes;
 }
 
 void ZPlayerAnimationData::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	std::string& frameCountXml = registeredAttributes.at("FrameCount").value;
+	const std::string& frameCountXml = GetAttribute("FrameCount").value;
 
 	frameCount = StringHelper::StrToL(frameCountXml);
 }
@@ -29,12 +35,7 @@ void ZPlayerAnimationData::ParseRawData()
 
 	size_t totalSize = GetRawDataSize();
 	// Divided by 2 because each value is an s16
-	limbRotData.reserve(totalSize * frameCount / 2);
-
-	for (size_t i = 0; i < totalSize; i += 2)
-	{
-		limbRotData.push_back(BitConverter::ToInt16BE(rawData, rawDataIndex + i));
-	}
+	limbRotData = BulkDecode::ReadS16Array(rawData, rawDataIndex, totalSize / 2);
 }
 
 Declaration* ZPlayerAnimationData::DeclareVar(const std::string& prefix, const std::string& bodyStr)
@@ -58,30 +59,26 @@ std::string ZPlayerAnimationData::GetBodySourceCode() const
 	if (Globals::Instance->otrMode)
 		return "";
 
-	size_t index = 0;
-	for (const auto entry : limbRotData)
-	{
-		if (index % 8 == 0)
+	// Indent, "-0x%04X, " and line feed are at most 1 + 9 + 1 bytes per entry
+	SourceEmitter::Append(declaration, limbRotData.size() * 11, [&](char* dst) {
+		for (size_t index = 0; index < limbRotData.size(); index++)
 		{
-			declaration += "\t";
-		}
+			int32_t entry = limbRotData[index];
 
-		if (entry < 0)
-		{
-			declaration += StringHelper::Sprintf("-0x%04X, ", -entry);
-		}
-		else
-		{
-			declaration += StringHelper::Sprintf("0x%04X, ", entry);
-		}
+			if (index % 8 == 0)
+				*dst++ = '\t';
 
-		if ((index + 1) % 8 == 0)
-		{
-			declaration += "\n";
-		}
+			if (entry < 0)
+				dst = SourceEmitter::Hex(SourceEmitter::Text(dst, "-0x"), -entry, 4);
+			else
+				dst = SourceEmitter::Hex(SourceEmitter::Text(dst, "0x"), entry, 4);
+			dst = SourceEmitter::Text(dst, ", ");
 
-		index++;
-	}
+			if ((index + 1) % 8 == 0)
+				*dst++ = '\n';
+		}
+		return dst;
+	});
 
 	return declaration;
 }
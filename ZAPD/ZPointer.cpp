@@ -8,16 +8,20 @@
 
 REGISTER_ZFILENODE(Pointer, ZPointer);
 
+static const ResourceAttributeSchema pointerAttributes(&ZResource::commonAttributes, {
+	{"Type", true},
+});
+
 ZPointer::ZPointer(ZFile* nParent) : ZResource(nParent)
 {
-	RegisterRequiredAttribute("Type");
+	attributeSchema = &pointerAttributes;
 }
 
 void ZPointer::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	type = registeredAttributes.at("Type").value;
+	type = GetAttribute("Type").value;
 }
 
 void ZPointer::ParseRawData()
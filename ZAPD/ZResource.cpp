@@ -3,6 +3,7 @@
 #include <cassert>
 #include <regex>
 
+#include "MemoryStats.h"
 #include "Utils/StringHelper.h"
 #include "WarningHandler.h"
 #include "ZFile.h"
@@ -11,6 +12,14 @@
 #include <ZDisplayList.h>
 #include <ZArray.h>
 
+const ResourceAttributeSchema ZResource::commonAttributes(nullptr, {
+	{"Name", true},
+	{"OutName", false},
+	{"Offset", false},
+	{"Custom", false},
+	{"Static", false, "Global"},
+});
+
 ZResource::ZResource(ZFile* nParent)
 {
 	// assert(nParent != nullptr);
@@ -21,12 +30,6 @@ ZResource::ZResource(ZFile* nParent)
 	rawDataIndex = 0;
 	outputDeclaration = true;
 	hash = 0;
-
-	RegisterRequiredAttribute("Name");
-	RegisterOptionalAttribute("OutName");
-	RegisterOptionalAttribute("Offset");
-	RegisterOptionalAttribute("Custom");
-	RegisterOptionalAttribute("Static", "Global");
 }
 
 void ZResource::ExtractWithXML(tinyxml2::XMLElement* reader, offset_t nRawDataIndex)
@@ -35,17 +38,22 @@ void ZResource::ExtractWithXML(tinyxml2::XMLElement* reader, offset_t nRawDataIn
 	declaredInXml = true;
 
 	if (reader != nullptr)
+	{
+		MemoryStatsScope memScope(MemoryPhase::ParseXML, GetResourceType());
 		ParseXML(reader);
+	}
 
 	// Don't parse raw data of external files
 	if (parent->GetMode() != ZFileMode::ExternalFile)
 	{
+		MemoryStatsScope memScope(MemoryPhase::ParseRawData, GetResourceType());
 		ParseRawData();
 		CalcHash();
 	}
 
 	if (!isInner)
 	{
+		MemoryStatsScope memScope(MemoryPhase::Declare, GetResourceType());
 		Declaration* decl = DeclareVar(parent->GetName(), "");
 		if (decl != nullptr)
 		{
@@ -71,31 +79,29 @@ void ZResource::ParseXML(tinyxml2::XMLElement* reader)
 {
 	if (reader != nullptr)
 	{
-		// If it is an inner node, then 'Name' isn't required
-		if (isInner)
-		{
-			registeredAttributes.at("Name").isRequired = false;
-		}
+		size_t attrCount = attributeSchema->GetCount();
+
+		attributeValues.clear();
+		attributeValues.reserve(attrCount);
+		for (size_t i = 0; i < attrCount; i++)
+			attributeValues.push_back(attributeSchema->GetDecl(i).defaultAttr);
 
 		auto attrs = reader->FirstAttribute();
 		while (attrs != nullptr)
 		{
-			std::string attrName = attrs->Name();
-			bool attrDeclared = false;
+			size_t index = attributeSchema->FindIndex(attrs->Name());
 
-			if (registeredAttributes.find(attrName) != registeredAttributes.end())
+			if (index < attrCount)
 			{
-				registeredAttributes[attrName].value = attrs->Value();
-				registeredAttributes[attrName].wasSet = true;
-				attrDeclared = true;
+				attributeValues[index].value = attrs->Value();
+				attributeValues[index].wasSet = true;
 			}
-
-			if (!attrDeclared)
+			else
 			{
 				HANDLE_WARNING_RESOURCE(
 					WarningType::UnknownAttribute, parent, this, rawDataIndex,
 					StringHelper::Sprintf("unexpected '%s' attribute in resource <%s>",
-				                          attrName.c_str(), reader->Name()),
+				                          attrs->Name(), reader->Name()),
 					"");
 			}
 			attrs = attrs->Next();
@@ -111,19 +117,25 @@ void ZResource::ParseXML(tinyxml2::XMLElement* reader)
 			}
 		}
 
-		for (const auto& attr : registeredAttributes)
+		for (size_t i = 0; i < attrCount; i++)
 		{
-			if (attr.second.isRequired && attr.second.value == "")
+			const ResourceAttributeDecl& decl = attributeSchema->GetDecl(i);
+
+			// If it is an inner node, then 'Name' isn't required
+			if (isInner && decl.key == "Name")
+				continue;
+
+			if (decl.isRequired && attributeValues[i].value == "")
 			{
 				std::string headerMsg =
 					StringHelper::Sprintf("missing required attribute '%s' in resource <%s>",
-				                          attr.first.c_str(), reader->Name());
+				                          decl.key.c_str(), reader->Name());
 				HANDLE_ERROR_RESOURCE(WarningType::MissingAttribute, parent, this, rawDataIndex,
 				                      headerMsg, "");
 			}
 		}
 
-		name = registeredAttributes.at("Name").value;
+		name = GetAttribute("Name").value;
 
 		// Disable this check for OTR file generation for now since it takes up a considerable amount of CPU time
 		if (!Globals::Instance->otrMode)
@@ -142,13 +154,13 @@ void ZResource::ParseXML(tinyxml2::XMLElement* reader)
 			}
 		}
 
-		outName = registeredAttributes.at("OutName").value;
+		outName = GetAttribute("OutName").value;
 		if (outName == "")
 			outName = name;
 
-		isCustomAsset = registeredAttributes["Custom"].wasSet;
+		isCustomAsset = GetAttribute("Custom").wasSet;
 
-		std::string& staticXml = registeredAttributes["Static"].value;
+		const std::string& staticXml = GetAttribute("Static").value;
 		if (staticXml == "Global")
 		{
 			staticConf = StaticConfig::Global;
@@ -271,6 +283,11 @@ std::string ZResource::GetBodySourceCode() const
 	return "ERROR";
 }
 
+bool ZResource::HasBodySourceCode() const
+{
+	return true;
+}
+
 std::string ZResource::GetDefaultName(const std::string& prefix) const
 {
 	return StringHelper::Sprintf("%s%s_%06X", prefix.c_str(), GetSourceTypeName().c_str(),
@@ -279,6 +296,28 @@ std::string ZResource::GetDefaultName(const std::string& prefix) const
 
 void ZResource::GetSourceOutputCode([[maybe_unused]] const std::string& prefix)
 {
+	bool isVtxArray = GetResourceType() == ZResourceType::Array &&
+	                  !((ZArray*)this)->resList.empty() &&
+	                  ((ZArray*)this)->resList[0]->GetResourceType() == ZResourceType::Vertex;
+
+	// Binary-only runs only need the declaration. The display list exporter reads vertices back
+	// from their text, so those are the only bodies still built
+	if (Globals::Instance->binaryOnly && !isVtxArray &&
+	    GetResourceType() != ZResourceType::Vertex)
+	{
+		if (!HasBodySourceCode())
+			return;
+
+		Declaration* decl = parent->GetDeclaration(rawDataIndex);
+
+		if (decl == nullptr || decl->isPlaceholder)
+			decl = DeclareVar(prefix, "");
+
+		if (decl != nullptr)
+			decl->staticConf = staticConf;
+		return;
+	}
+
 	std::string bodyStr = GetBodySourceCode();
 
 	if (bodyStr != "ERROR")
@@ -291,17 +330,14 @@ void ZResource::GetSourceOutputCode([[maybe_unused]] const std::string& prefix)
 			decl->declBody = bodyStr;
 
 		// OTRTODO: This is a hack and we need something more elegant in the future...
-		if (GetResourceType() == ZResourceType::Array)
+		if (isVtxArray)
 		{
 			ZArray* arr = (ZArray*)this;
-			if (arr->resList[0]->GetResourceType() == ZResourceType::Vertex)
+			for (int i = 0; i < arr->resList.size(); i++)
 			{
-				for (int i = 0; i < arr->resList.size(); i++)
-				{
-					ZVtx* vtx = (ZVtx*)arr->resList[i];
-					decl->vertexHack.push_back(vtx);
+				ZVtx* vtx = (ZVtx*)arr->resList[i];
+				decl->vertexHack.push_back(vtx);
 
-				}
 			}
 		}
 
@@ -400,20 +436,70 @@ void ZResource::SetInnerNode(bool inner)
 	isInner = inner;
 }
 
-void ZResource::RegisterRequiredAttribute(const std::string& attr)
+const ResourceAttribute& ZResource::GetAttribute(std::string_view key) const
 {
-	ResourceAttribute resAtrr;
-	resAtrr.key = attr;
-	resAtrr.isRequired = true;
-	registeredAttributes[attr] = resAtrr;
+	size_t index = attributeSchema->FindIndex(key);
+
+	if (index >= attributeSchema->GetCount())
+	{
+		throw std::runtime_error(
+			StringHelper::Sprintf("ZResource::GetAttribute: attribute '%s' is not registered",
+		                          std::string(key).c_str()));
+	}
+
+	// Resources that never went through ParseXML only have the defaults
+	if (attributeValues.empty())
+		return attributeSchema->GetDecl(index).defaultAttr;
+
+	return attributeValues[index];
+}
+
+ResourceAttributeDecl::ResourceAttributeDecl(const char* nKey, bool nIsRequired,
+                                             const char* nDefaultValue)
+	: key(nKey), isRequired(nIsRequired)
+{
+	defaultAttr.value = nDefaultValue;
+}
+
+ResourceAttributeSchema::ResourceAttributeSchema(
+	const ResourceAttributeSchema* nBase, std::initializer_list<ResourceAttributeDecl> nDecls)
+	: base(nBase), decls(nDecls)
+{
+}
+
+size_t ResourceAttributeSchema::GetCount() const
+{
+	return (base != nullptr ? base->GetCount() : 0) + decls.size();
 }
 
-void ZResource::RegisterOptionalAttribute(const std::string& attr, const std::string& defaultValue)
+const ResourceAttributeDecl& ResourceAttributeSchema::GetDecl(size_t index) const
 {
-	ResourceAttribute resAtrr;
-	resAtrr.key = attr;
-	resAtrr.value = defaultValue;
-	registeredAttributes[attr] = resAtrr;
+	size_t baseCount = base != nullptr ? base->GetCount() : 0;
+
+	if (index < baseCount)
+		return base->GetDecl(index);
+
+	return decls.at(index - baseCount);
+}
+
+size_t ResourceAttributeSchema::FindIndex(std::string_view key) const
+{
+	size_t baseCount = base != nullptr ? base->GetCount() : 0;
+
+	for (size_t i = 0; i < decls.size(); i++)
+	{
+		if (decls[i].key == key)
+			return baseCount + i;
+	}
+
+	if (base != nullptr)
+	{
+		size_t index = base->FindIndex(key);
+		if (index < baseCount)
+			return index;
+	}
+
+	return GetCount();
 }
 
 offset_t Seg2Filespace(segptr_t segmentedAddress, uint32_t parentBaseAddress)
@@ -5,6 +5,7 @@
 #include <set>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "Declaration.h"
 #include <Utils/BinaryWriter.h>
@@ -63,12 +64,41 @@ enum class ZResourceType
 class ResourceAttribute
 {
 public:
-	std::string key;
 	std::string value;
-	bool isRequired = false;
 	bool wasSet = false;
 };
 
+class ResourceAttributeDecl
+{
+public:
+	std::string key;
+	bool isRequired = false;
+	// The value used if the attribute is missing or the XML was never parsed
+	ResourceAttribute defaultAttr;
+
+	ResourceAttributeDecl(const char* nKey, bool nIsRequired, const char* nDefaultValue = "");
+};
+
+/**
+ * The set of XML attributes accepted by a resource type.
+ * Declared once per type (as a static) and extended from the schema of the parent type.
+ */
+class ResourceAttributeSchema
+{
+public:
+	ResourceAttributeSchema(const ResourceAttributeSchema* nBase,
+	                        std::initializer_list<ResourceAttributeDecl> nDecls);
+
+	[[nodiscard]] size_t GetCount() const;
+	[[nodiscard]] const ResourceAttributeDecl& GetDecl(size_t index) const;
+	// Returns GetCount() if the key isn't part of the schema
+	[[nodiscard]] size_t FindIndex(std::string_view key) const;
+
+protected:
+	const ResourceAttributeSchema* base;
+	std::vector<ResourceAttributeDecl> decls;
+};
+
 class ZResource
 {
 public:
@@ -77,6 +107,9 @@ public:
 	uint32_t hash = 0;
 	bool genOTRDef = false;
 
+	// Attributes shared by every resource (Name, OutName, Offset, Custom and Static)
+	static const ResourceAttributeSchema commonAttributes;
+
 	/**
 	 * Constructor.
 	 * Child classes should not declare any other constructor besides this one
@@ -101,8 +134,7 @@ public:
 	// Misc
 	/**
 	 * Parses additional attributes of the XML node.
-	 * Extra attritbutes have to be registered using `RegisterRequiredAttribute` or
-	 * `RegisterOptionalAttribute` in the constructor of the ZResource
+	 * Extra attritbutes have to be declared in the `attributeSchema` of the ZResource
 	 */
 	virtual void ParseXML(tinyxml2::XMLElement* reader);
 	/**
@@ -126,6 +158,11 @@ public:
 	 * Returns the body of the variable of the extracted resource, without any side-effect
 	 */
 	[[nodiscard]] virtual std::string GetBodySourceCode() const;
+	/**
+	 * Returns false if GetBodySourceCode has no body to give (it returns "ERROR"), so
+	 * binary-only runs can skip the same resources without building the body
+	 */
+	[[nodiscard]] virtual bool HasBodySourceCode() const;
 	/**
 	 * Creates an automatically generated variable name for the current resource
 	 */
@@ -211,18 +248,19 @@ protected:
 	bool declaredInXml = false;
 	StaticConfig staticConf = StaticConfig::Global;
 
-	// Reading from this XMLs attributes should be performed in the overrided `ParseXML` method.
-	std::map<std::string, ResourceAttribute> registeredAttributes;
+	// XML attributes accepted by this resource type.
+	// Child classes with extra attributes should point this to their own static schema (extending
+	// `commonAttributes`) in their constructor. Required attributes that are not provided make the
+	// program throw an exception; optional ones have to be checked manually.
+	const ResourceAttributeSchema* attributeSchema = &commonAttributes;
 
-	// XML attributes registers.
-	// Registering XML attributes should be done in constructors.
+	// Reading from this XMLs attributes should be performed in the overrided `ParseXML` method.
+	// Attributes that aren't part of the schema throw.
+	[[nodiscard]] const ResourceAttribute& GetAttribute(std::string_view key) const;
 
-	// The resource needs this attribute. If it is not provided, then the program will throw an
-	// exception.
-	void RegisterRequiredAttribute(const std::string& attr);
-	// Optional attribute. The resource has to do manual checks and manual warnings. It may or may
-	// not have a value.
-	void RegisterOptionalAttribute(const std::string& attr, const std::string& defaultValue = "");
+private:
+	// Only allocated once ParseXML runs, indexed the same way as `attributeSchema`
+	std::vector<ResourceAttribute> attributeValues;
 };
 
 class ZResourceExporter
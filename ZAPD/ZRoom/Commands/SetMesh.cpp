@@ -144,7 +144,9 @@ std::string RoomShapeDListsEntry::GetBodySourceCode() const
 
 void RoomShapeDListsEntry::GetSourceOutputCode(const std::string& prefix)
 {
-	std::string bodyStr = StringHelper::Sprintf("\n\t%s\n", GetBodySourceCode().c_str());
+	std::string bodyStr;
+	if (!Globals::Instance->binaryOnly)
+		bodyStr = StringHelper::Sprintf("\n\t%s\n", GetBodySourceCode().c_str());
 
 	Declaration* decl = parent->GetDeclaration(rawDataIndex);
 
@@ -199,12 +201,11 @@ ZDisplayList* RoomShapeDListsEntry::MakeDlist(segptr_t ptr,
 
 	uint32_t dlistAddress = Seg2Filespace(ptr, parent->baseAddress);
 
-	int32_t dlistLength = ZDisplayList::GetDListLength(
-		parent->GetRawData(), dlistAddress,
-		Globals::Instance->game == ZGame::OOT_SW97 ? DListType::F3DEX : DListType::F3DZEX);
 	ZDisplayList* dlist = new ZDisplayList(parent);
 	parent->AddResource(dlist);
-	dlist->ExtractFromBinary(dlistAddress, dlistLength);
+	dlist->ExtractFromBinary(dlistAddress, Globals::Instance->game == ZGame::OOT_SW97 ?
+	                                           DListType::F3DEX :
+	                                           DListType::F3DZEX);
 	dlist->SetName(dlist->GetDefaultName(prefix));
 	GenDListDeclarations(zRoom, parent, dlist);
 
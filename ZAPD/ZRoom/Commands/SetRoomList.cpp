@@ -118,7 +118,7 @@ std::string RomFile::GetBodySourceCode() const
 
 void RomFile::GetSourceOutputCode(const std::string& prefix)
 {
-	DeclareVar(prefix, GetBodySourceCode());
+	DeclareVar(prefix, Globals::Instance->binaryOnly ? "" : GetBodySourceCode());
 }
 
 std::string RomFile::GetSourceTypeName() const
@@ -51,11 +51,15 @@ REGISTER_ZFILENODE(Room, ZRoom);
 REGISTER_ZFILENODE(Scene, ZRoom);
 REGISTER_ZFILENODE(AltHeader, ZRoom);
 
+static const ResourceAttributeSchema roomAttributes(&ZResource::commonAttributes, {
+	{"HackMode", false},
+});
+
 ZRoom::ZRoom(ZFile* nParent) : ZResource(nParent)
 {
 	roomCount = -1;
 	canHaveInner = true;
-	RegisterOptionalAttribute("HackMode");
+	attributeSchema = &roomAttributes;
 }
 
 ZRoom::~ZRoom()
@@ -383,7 +387,7 @@ size_t ZRoom::GetCommandSizeFromNeighbor(ZRoomCommand* cmd)
 void ZRoom::GetSourceOutputCode([[maybe_unused]] const std::string& prefix)
 {
 	if (hackMode != "syotes_room")
-		DeclareVar(prefix, GetBodySourceCode());
+		DeclareVar(prefix, Globals::Instance->binaryOnly ? "" : GetBodySourceCode());
 }
 
 size_t ZRoom::GetRawDataSize() const
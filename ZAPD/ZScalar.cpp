@@ -9,11 +9,15 @@
 
 REGISTER_ZFILENODE(Scalar, ZScalar);
 
+static const ResourceAttributeSchema scalarAttributes(&ZResource::commonAttributes, {
+	{"Type", true},
+});
+
 ZScalar::ZScalar(ZFile* nParent) : ZResource(nParent)
 {
 	memset(&scalarData, 0, sizeof(ZScalarData));
 	scalarType = ZScalarType::ZSCALAR_NONE;
-	RegisterRequiredAttribute("Type");
+	attributeSchema = &scalarAttributes;
 }
 
 void ZScalar::ExtractFromBinary(uint32_t nRawDataIndex, ZScalarType nScalarType)
@@ -32,7 +36,7 @@ void ZScalar::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	scalarType = ZScalar::MapOutputTypeToScalarType(registeredAttributes.at("Type").value);
+	scalarType = ZScalar::MapOutputTypeToScalarType(GetAttribute("Type").value);
 }
 
 ZScalarType ZScalar::MapOutputTypeToScalarType(const std::string& type)
@@ -10,16 +10,17 @@
 REGISTER_ZFILENODE(Skeleton, ZSkeleton);
 REGISTER_ZFILENODE(LimbTable, ZLimbTable);
 
+static const ResourceAttributeSchema skeletonAttributes(&ZResource::commonAttributes, {
+	{"Type", true},
+	{"LimbType", true},
+	{"EnumName", false},
+	{"LimbNone", false},
+	{"LimbMax", false},
+});
+
 ZSkeleton::ZSkeleton(ZFile* nParent) : ZResource(nParent)
 {
-	RegisterRequiredAttribute("Type");
-	RegisterRequiredAttribute("LimbType");
-	genOTRDef = true;
-
-	RegisterOptionalAttribute("EnumName");
-	RegisterOptionalAttribute("LimbNone");
-	RegisterOptionalAttribute("LimbMax");
-
+	attributeSchema = &skeletonAttributes;
 	genOTRDef = true;
 }
 
@@ -27,7 +28,7 @@ void ZSkeleton::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	std::string skelTypeXml = registeredAttributes.at("Type").value;
+	std::string skelTypeXml = GetAttribute("Type").value;
 
 	if (skelTypeXml == "Flex")
 		type = ZSkeletonType::Flex;
@@ -39,7 +40,7 @@ void ZSkeleton::ParseXML(tinyxml2::XMLElement* reader)
 		                      "invalid value found for 'Type' attribute", "");
 	}
 
-	std::string limbTypeXml = registeredAttributes.at("LimbType").value;
+	std::string limbTypeXml = GetAttribute("LimbType").value;
 	limbType = ZLimb::GetTypeByAttributeName(limbTypeXml);
 	if (limbType == ZLimbType::Invalid)
 	{
@@ -50,9 +51,9 @@ void ZSkeleton::ParseXML(tinyxml2::XMLElement* reader)
 			"Defaulting to 'Standard'.");
 	}
 
-	enumName = registeredAttributes.at("EnumName").value;
-	limbNoneName = registeredAttributes.at("LimbNone").value;
-	limbMaxName = registeredAttributes.at("LimbMax").value;
+	enumName = GetAttribute("EnumName").value;
+	limbNoneName = GetAttribute("LimbNone").value;
+	limbMaxName = GetAttribute("LimbMax").value;
 
 	if (enumName != "")
 	{
@@ -217,13 +218,17 @@ uint8_t ZSkeleton::GetLimbCount()
 
 /* ZLimbTable */
 
+static const ResourceAttributeSchema limbTableAttributes(&ZResource::commonAttributes, {
+	{"LimbType", true},
+	{"Count", true},
+	{"EnumName", false},
+	{"LimbNone", false},
+	{"LimbMax", false},
+});
+
 ZLimbTable::ZLimbTable(ZFile* nParent) : ZResource(nParent)
 {
-	RegisterRequiredAttribute("LimbType");
-	RegisterRequiredAttribute("Count");
-	RegisterOptionalAttribute("EnumName");
-	RegisterOptionalAttribute("LimbNone");
-	RegisterOptionalAttribute("LimbMax");
+	attributeSchema = &limbTableAttributes;
 }
 
 void ZLimbTable::ExtractFromBinary(uint32_t nRawDataIndex, ZLimbType nLimbType, size_t nCount)
@@ -239,7 +244,7 @@ void ZLimbTable::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	std::string limbTypeXml = registeredAttributes.at("LimbType").value;
+	std::string limbTypeXml = GetAttribute("LimbType").value;
 	limbType = ZLimb::GetTypeByAttributeName(limbTypeXml);
 	if (limbType == ZLimbType::Invalid)
 	{
@@ -249,11 +254,11 @@ void ZLimbTable::ParseXML(tinyxml2::XMLElement* reader)
 		limbType = ZLimbType::Standard;
 	}
 
-	count = StringHelper::StrToL(registeredAttributes.at("Count").value);
+	count = StringHelper::StrToL(GetAttribute("Count").value);
 
-	enumName = registeredAttributes.at("EnumName").value;
-	limbNoneName = registeredAttributes.at("LimbNone").value;
-	limbMaxName = registeredAttributes.at("LimbMax").value;
+	enumName = GetAttribute("EnumName").value;
+	limbNoneName = GetAttribute("LimbNone").value;
+	limbMaxName = GetAttribute("LimbMax").value;
 
 	if (enumName != "")
 	{
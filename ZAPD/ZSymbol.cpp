@@ -6,18 +6,22 @@
 
 REGISTER_ZFILENODE(Symbol, ZSymbol);
 
+static const ResourceAttributeSchema symbolAttributes(&ZResource::commonAttributes, {
+	{"Type", false},
+	{"TypeSize", false},
+	{"Count", false},
+});
+
 ZSymbol::ZSymbol(ZFile* nParent) : ZResource(nParent)
 {
-	RegisterOptionalAttribute("Type");
-	RegisterOptionalAttribute("TypeSize");
-	RegisterOptionalAttribute("Count");
+	attributeSchema = &symbolAttributes;
 }
 
 void ZSymbol::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	std::string typeXml = registeredAttributes.at("Type").value;
+	std::string typeXml = GetAttribute("Type").value;
 
 	if (typeXml == "")
 	{
@@ -30,7 +34,7 @@ void ZSymbol::ParseXML(tinyxml2::XMLElement* reader)
 		type = typeXml;
 	}
 
-	std::string typeSizeXml = registeredAttributes.at("TypeSize").value;
+	std::string typeSizeXml = GetAttribute("TypeSize").value;
 	if (typeSizeXml == "")
 	{
 		HANDLE_WARNING_RESOURCE(WarningType::MissingAttribute, parent, this, rawDataIndex,
@@ -42,16 +46,16 @@ void ZSymbol::ParseXML(tinyxml2::XMLElement* reader)
 		typeSize = StringHelper::StrToL(typeSizeXml, 0);
 	}
 
-	if (registeredAttributes.at("Count").wasSet)
+	if (GetAttribute("Count").wasSet)
 	{
 		isArray = true;
 
-		std::string countXml = registeredAttributes.at("Count").value;
+		std::string countXml = GetAttribute("Count").value;
 		if (countXml != "")
 			count = StringHelper::StrToL(countXml, 0);
 	}
 
-	if (registeredAttributes.at("Static").value == "On")
+	if (GetAttribute("Static").value == "On")
 	{
 		HANDLE_WARNING_RESOURCE(WarningType::InvalidAttributeValue, parent, this, rawDataIndex,
 		                        "a <Symbol> cannot be marked as static",
@@ -92,6 +96,11 @@ std::string ZSymbol::GetSourceTypeName() const
 	return type;
 }
 
+bool ZSymbol::HasBodySourceCode() const
+{
+	return false;
+}
+
 ZResourceType ZSymbol::GetResourceType() const
 {
 	return ZResourceType::Symbol;
@@ -21,6 +21,7 @@ public:
 	std::string GetSourceOutputHeader(const std::string& prefix, std::set<std::string> *nameSet) override;
 
 	std::string GetSourceTypeName() const override;
+	bool HasBodySourceCode() const override;
 	ZResourceType GetResourceType() const override;
 
 	size_t GetRawDataSize() const override;
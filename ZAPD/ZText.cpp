@@ -9,10 +9,14 @@
 
 REGISTER_ZFILENODE(Text, ZText);
 
+static const ResourceAttributeSchema textAttributes(&ZResource::commonAttributes, {
+	{"CodeOffset", true},
+	{"LangOffset", false, "0"},
+});
+
 ZText::ZText(ZFile* nParent) : ZResource(nParent)
 {
-	RegisterRequiredAttribute("CodeOffset");
-	RegisterOptionalAttribute("LangOffset", "0");
+	attributeSchema = &textAttributes;
 }
 
 void ZText::ParseRawData()
@@ -20,13 +24,13 @@ void ZText::ParseRawData()
 	ZResource::ParseRawData();
 
 	const auto& rawData = parent->GetRawData();
-	uint32_t currentPtr = StringHelper::StrToL(registeredAttributes.at("CodeOffset").value, 16);
+	uint32_t currentPtr = StringHelper::StrToL(GetAttribute("CodeOffset").value, 16);
 	uint32_t langPtr = currentPtr;
 	bool isPalLang = false;
 
-	if (StringHelper::StrToL(registeredAttributes.at("LangOffset").value, 16) != 0)
+	if (StringHelper::StrToL(GetAttribute("LangOffset").value, 16) != 0)
 	{
-		langPtr = StringHelper::StrToL(registeredAttributes.at("LangOffset").value, 16);
+		langPtr = StringHelper::StrToL(GetAttribute("LangOffset").value, 16);
 
 		if (langPtr != currentPtr)
 			isPalLang = true;
@@ -131,6 +135,11 @@ size_t ZText::GetRawDataSize() const
 	return 1;
 }
 
+bool ZText::HasBodySourceCode() const
+{
+	return false;
+}
+
 ZResourceType ZText::GetResourceType() const
 {
 	return ZResourceType::Text;
@@ -24,6 +24,7 @@ public:
 	void ParseRawData() override;
 
 	std::string GetSourceTypeName() const override;
+	bool HasBodySourceCode() const override;
 	ZResourceType GetResourceType() const override;
 
 	size_t GetRawDataSize() const override;
@@ -1,9 +1,17 @@
 #include "ZTexture.h"
 
+#include <atomic>
 #include <cassert>
+#include <cinttypes>
+#include <cstring>
 
+#include "BulkDecode.h"
 #include "CRC32.h"
 #include "Globals.h"
+#include "PngEncodeQueue.h"
+#include "SourceEmitter.h"
+#include "TextureCache.h"
+#include "TextureDecode.h"
 #include "Utils/BitConverter.h"
 #include "Utils/Directory.h"
 #include <Utils/DiskFile.h>
@@ -18,6 +26,27 @@
 
 REGISTER_ZFILENODE(Texture, ZTexture);
 
+static std::atomic<uint64_t> rgba8ExportCount{0};
+static std::atomic<uint64_t> rgba8ExportRawBytes{0};
+static std::atomic<uint64_t> rgba8ExportBytes{0};
+
+static const ResourceAttributeSchema textureAttributes(&ZResource::commonAttributes, {
+	{"Width", true},
+	{"Height", true},
+	{"Format", true},
+	{"TlutOffset", false},
+	{"ExternalTlut", false},
+	{"ExternalTlutOffset", false},
+	{"SplitTlut", false},
+
+	// Dummy property added by https://github.com/HarbourMasters/Shipwright/pull/3161
+	// Used to indicate if a resource definition was added through a script
+	// and to enable easy removal/re-add of the definitions when introducing new rom support
+	// Can be removed once we feel it is no longer useful
+	// This is not used in ZAPD itself, the registration is to prevent missing attribute errors
+	{"AddedByScript", false},
+});
+
 ZTexture::ZTexture(ZFile* nParent) : ZResource(nParent)
 {
 	width = 0;
@@ -26,20 +55,7 @@ ZTexture::ZTexture(ZFile* nParent) : ZResource(nParent)
 	genOTRDef = true;
 	splitTlut = false;
 
-	RegisterRequiredAttribute("Width");
-	RegisterRequiredAttribute("Height");
-	RegisterRequiredAttribute("Format");
-	RegisterOptionalAttribute("TlutOffset");
-	RegisterOptionalAttribute("ExternalTlut");
-	RegisterOptionalAttribute("ExternalTlutOffset");
-	RegisterOptionalAttribute("SplitTlut");
-
-	// Dummy property added by https://github.com/HarbourMasters/Shipwright/pull/3161
-	// Used to indicate if a resource definition was added through a script
-	// and to enable easy removal/re-add of the definitions when introducing new rom support
-	// Can be removed once we feel it is no longer useful
-	// This is not used in ZAPD itself, the registration is to prevent missing attribute errors
-	RegisterOptionalAttribute("AddedByScript");
+	attributeSchema = &textureAttributes;
 }
 
 void ZTexture::ExtractFromBinary(uint32_t nRawDataIndex, int32_t nWidth, int32_t nHeight,
@@ -72,9 +88,9 @@ void ZTexture::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	std::string widthXml = registeredAttributes.at("Width").value;
-	std::string heightXml = registeredAttributes.at("Height").value;
-	std::string SplitTlutXml = registeredAttributes.at("SplitTlut").value;
+	std::string widthXml = GetAttribute("Width").value;
+	std::string heightXml = GetAttribute("Height").value;
+	std::string SplitTlutXml = GetAttribute("SplitTlut").value;
 
 	if (!StringHelper::HasOnlyDigits(widthXml))
 	{
@@ -91,8 +107,8 @@ void ZTexture::ParseXML(tinyxml2::XMLElement* reader)
 		                      errorHeader, "");
 	}
 
-	if (!registeredAttributes.at("ExternalTlut").wasSet &&
-	    registeredAttributes.at("SplitTlut").wasSet)
+	if (!GetAttribute("ExternalTlut").wasSet &&
+	    GetAttribute("SplitTlut").wasSet)
 	{
 		std::string errorHeader =
 			StringHelper::Sprintf("SplitTlut set without using an external tlut");
@@ -115,7 +131,7 @@ void ZTexture::ParseXML(tinyxml2::XMLElement* reader)
 	width = StringHelper::StrToL(widthXml);
 	height = StringHelper::StrToL(heightXml);
 
-	std::string formatStr = registeredAttributes.at("Format").value;
+	std::string formatStr = GetAttribute("Format").value;
 	format = GetTextureTypeFromString(formatStr);
 
 	if (format == TextureType::Error)
@@ -124,7 +140,7 @@ void ZTexture::ParseXML(tinyxml2::XMLElement* reader)
 		                      "invalid value found for 'Format' attribute", "");
 	}
 
-	const auto& tlutOffsetAttr = registeredAttributes.at("TlutOffset");
+	const auto& tlutOffsetAttr = GetAttribute("TlutOffset");
 	if (tlutOffsetAttr.wasSet)
 	{
 		switch (format)
@@ -148,6 +164,21 @@ void ZTexture::ParseRawData()
 	if (rawDataIndex % 8 != 0)
 		dWordAligned = false;
 
+	cacheEntry = nullptr;
+	if (TextureCache::IsEnabled() && format != TextureType::Error)
+	{
+		size_t size = GetRawDataSize();
+		const uint8_t* data = GetRawDataSpan(size);
+
+		hash = CRC32B(data, size);
+		cacheEntry = TextureCache::Find(format, width, height, hash, data, size);
+		if (cacheEntry != nullptr)
+		{
+			textureData = cacheEntry->image;
+			return;
+		}
+	}
+
 	switch (format)
 	{
 	case TextureType::RGBA16bpp:
@@ -183,22 +214,30 @@ void ZTexture::ParseRawData()
 		assert(!"TODO");
 		break;
 	}
+
+	if (TextureCache::IsEnabled() && format != TextureType::Error)
+	{
+		size_t size = GetRawDataSize();
+		cacheEntry =
+			TextureCache::Insert(parent->GetName(), rawDataIndex, dWordAligned, format, width,
+		                         height, hash, GetRawDataSpan(size), size, textureData);
+	}
 }
 
 void ZTexture::ParseRawDataLate()
 {
-	if (registeredAttributes["ExternalTlut"].wasSet)
+	if (GetAttribute("ExternalTlut").wasSet)
 	{
-		const std::string externPalette = registeredAttributes["ExternalTlut"].value;
+		const std::string externPalette = GetAttribute("ExternalTlut").value;
 		for (const auto& file : Globals::Instance->files)
 		{
 			if (file->GetName() == externPalette)
 			{
 				offset_t palOffset = 0;
-				if (registeredAttributes["ExternalTlutOffset"].wasSet)
+				if (GetAttribute("ExternalTlutOffset").wasSet)
 				{
 					palOffset =
-						StringHelper::StrToL(registeredAttributes["ExternalTlutOffset"].value, 16);
+						StringHelper::StrToL(GetAttribute("ExternalTlutOffset").value, 16);
 				}
 				else
 				{
@@ -226,189 +265,119 @@ void ZTexture::ParseRawDataLate()
 	}
 }
 
+const uint8_t* ZTexture::GetRawDataSpan(size_t size) const
+{
+	const auto& parentRawData = parent->GetRawData();
+
+	BulkDecode::CheckBounds(parentRawData, rawDataIndex, size, "ZTexture::GetRawDataSpan");
+	return parentRawData.data() + rawDataIndex;
+}
+
 void ZTexture::ConvertN64ToBitmap_RGBA16()
 {
 	textureData.InitEmptyRGBImage(width, height, true);
-	const auto& parentRawData = parent->GetRawData();
+	const uint8_t* src = GetRawDataSpan(width * height * 2);
+
 	for (size_t y = 0; y < height; y++)
-	{
-		for (size_t x = 0; x < width; x++)
-		{
-			int32_t pos = rawDataIndex + ((y * width) + x) * 2;
-			uint16_t data = parentRawData.at(pos + 1) | (parentRawData.at(pos) << 8);
-			uint8_t r = (data & 0xF800) >> 11;
-			uint8_t g = (data & 0x07C0) >> 6;
-			uint8_t b = (data & 0x003E) >> 1;
-			uint8_t alpha = data & 0x01;
-
-			textureData.SetRGBPixel(y, x, (r << 3) | (r >> 2), (g << 3) | (g >> 2),
-			                        (b << 3) | (b >> 2), alpha * 255);
-		}
-	}
+		TextureDecode::RGBA16ToRGBA8(src + y * width * 2, textureData.GetRowData(y), width);
 }
 
 void ZTexture::ConvertN64ToBitmap_RGBA32()
 {
 	textureData.InitEmptyRGBImage(width, height, true);
-	const auto& parentRawData = parent->GetRawData();
-	for (size_t y = 0; y < height; y++)
-	{
-		for (size_t x = 0; x < width; x++)
-		{
-			size_t pos = rawDataIndex + ((y * width) + x) * 4;
-			uint8_t r = parentRawData.at(pos + 0);
-			uint8_t g = parentRawData.at(pos + 1);
-			uint8_t b = parentRawData.at(pos + 2);
-			uint8_t alpha = parentRawData.at(pos + 3);
+	const uint8_t* src = GetRawDataSpan(width * height * 4);
 
-			textureData.SetRGBPixel(y, x, r, g, b, alpha);
-		}
-	}
+	for (size_t y = 0; y < height; y++)
+		TextureDecode::RGBA32ToRGBA8(src + y * width * 4, textureData.GetRowData(y), width);
 }
 
 void ZTexture::ConvertN64ToBitmap_Grayscale4()
 {
 	textureData.InitEmptyRGBImage(width, height, false);
-	const auto& parentRawData = parent->GetRawData();
-	for (size_t y = 0; y < height; y++)
-	{
-		for (size_t x = 0; x < width; x += 2)
-		{
-			for (uint8_t i = 0; i < 2; i++)
-			{
-				size_t pos = rawDataIndex + ((y * width) + x) / 2;
-				uint8_t grayscale = 0;
-
-				if (i == 0)
-					grayscale = parentRawData.at(pos) & 0xF0;
-				else
-					grayscale = (parentRawData.at(pos) & 0x0F) << 4;
+	const uint8_t* src = GetRawDataSpan((width * height + 1) / 2);
 
-				textureData.SetGrayscalePixel(y, x + i, (grayscale << 4) | grayscale);
-			}
-		}
-	}
+	for (size_t y = 0; y < height; y++)
+		TextureDecode::I4ToRGB8(src + (y * width) / 2, textureData.GetRowData(y), width);
 }
 
 void ZTexture::ConvertN64ToBitmap_Grayscale8()
 {
 	textureData.InitEmptyRGBImage(width, height, false);
-	const auto& parentRawData = parent->GetRawData();
-	for (size_t y = 0; y < height; y++)
-	{
-		for (size_t x = 0; x < width; x++)
-		{
-			size_t pos = rawDataIndex + ((y * width) + x) * 1;
+	const uint8_t* src = GetRawDataSpan(width * height);
 
-			textureData.SetGrayscalePixel(y, x, parentRawData.at(pos));
-		}
-	}
+	for (size_t y = 0; y < height; y++)
+		TextureDecode::I8ToRGB8(src + y * width, textureData.GetRowData(y), width);
 }
 
 void ZTexture::ConvertN64ToBitmap_GrayscaleAlpha4()
 {
 	textureData.InitEmptyRGBImage(width, height, true);
-	const auto& parentRawData = parent->GetRawData();
-	for (size_t y = 0; y < height; y++)
-	{
-		for (size_t x = 0; x < width; x += 2)
-		{
-			for (uint16_t i = 0; i < 2; i++)
-			{
-				size_t pos = rawDataIndex + ((y * width) + x) / 2;
-				uint8_t data = 0;
+	const uint8_t* src = GetRawDataSpan((width * height + 1) / 2);
 
-				if (i == 0)
-					data = (parentRawData.at(pos) & 0xF0) >> 4;
-				else
-					data = parentRawData.at(pos) & 0x0F;
-
-				uint8_t grayscale = data & 0b1110;
-				grayscale = (grayscale << 4) | (grayscale << 1) | (grayscale >> 2);
-				uint8_t alpha = (data & 0x01) ? 255 : 0;
-
-				textureData.SetGrayscalePixel(y, x + i, grayscale, alpha);
-			}
-		}
-	}
+	for (size_t y = 0; y < height; y++)
+		TextureDecode::IA4ToRGBA8(src + (y * width) / 2, textureData.GetRowData(y), width);
 }
 
 void ZTexture::ConvertN64ToBitmap_GrayscaleAlpha8()
 {
 	textureData.InitEmptyRGBImage(width, height, true);
-	const auto& parentRawData = parent->GetRawData();
-	for (size_t y = 0; y < height; y++)
-	{
-		for (size_t x = 0; x < width; x++)
-		{
-			size_t pos = rawDataIndex + ((y * width) + x) * 1;
-			uint8_t pixel = parentRawData.at(pos);
-			uint8_t data = (pixel >> 4) & 0xF;
-
-			data = (data << 4) | data;
-			uint8_t grayscale = data;
-			uint8_t alpha = (pixel & 0xF);
-			alpha = (alpha << 4) | alpha;
+	const uint8_t* src = GetRawDataSpan(width * height);
 
-			textureData.SetGrayscalePixel(y, x, grayscale, alpha);
-		}
-	}
+	for (size_t y = 0; y < height; y++)
+		TextureDecode::IA8ToRGBA8(src + y * width, textureData.GetRowData(y), width);
 }
 
 void ZTexture::ConvertN64ToBitmap_GrayscaleAlpha16()
 {
 	textureData.InitEmptyRGBImage(width, height, true);
-	const auto& parentRawData = parent->GetRawData();
-	for (size_t y = 0; y < height; y++)
-	{
-		for (size_t x = 0; x < width; x++)
-		{
-			size_t pos = rawDataIndex + ((y * width) + x) * 2;
-			uint8_t grayscale = parentRawData.at(pos + 0);
-			uint8_t alpha = parentRawData.at(pos + 1);
+	const uint8_t* src = GetRawDataSpan(width * height * 2);
 
-			textureData.SetGrayscalePixel(y, x, grayscale, alpha);
-		}
-	}
+	for (size_t y = 0; y < height; y++)
+		TextureDecode::IA16ToRGBA8(src + y * width * 2, textureData.GetRowData(y), width);
 }
 
 void ZTexture::ConvertN64ToBitmap_Palette4()
 {
 	textureData.InitEmptyPaletteImage(width, height);
-	const auto& parentRawData = parent->GetRawData();
+	const uint8_t* src = GetRawDataSpan((width * height + 1) / 2);
+	bool usedIndices[16] = {};
+
 	for (size_t y = 0; y < height; y++)
 	{
-		for (size_t x = 0; x < width; x += 2)
-		{
-			for (uint16_t i = 0; i < 2; i++)
-			{
-				size_t pos = rawDataIndex + ((y * width) + x) / 2;
-				uint8_t paletteIndex = 0;
+		uint8_t* row = textureData.GetRowData(y);
 
-				if (i == 0)
-					paletteIndex = (parentRawData.at(pos) & 0xF0) >> 4;
-				else
-					paletteIndex = (parentRawData.at(pos) & 0x0F);
+		TextureDecode::CI4ToIndex(src + (y * width) / 2, row, width);
+		for (size_t x = 0; x < width; x++)
+			usedIndices[row[x]] = true;
+	}
 
-				textureData.SetIndexedPixel(y, x + i, paletteIndex, paletteIndex * 16);
-			}
-		}
+	// Without a TLUT, every used index is shown as a shade of gray
+	for (uint8_t i = 0; i < 16; i++)
+	{
+		if (usedIndices[i])
+			textureData.SetPaletteIndex(i, i * 16, i * 16, i * 16, 255);
 	}
 }
 
 void ZTexture::ConvertN64ToBitmap_Palette8()
 {
 	textureData.InitEmptyPaletteImage(width, height);
-	const auto& parentRawData = parent->GetRawData();
+	const uint8_t* src = GetRawDataSpan(width * height);
+	bool usedIndices[256] = {};
+
 	for (size_t y = 0; y < height; y++)
 	{
+		uint8_t* row = textureData.GetRowData(y);
+
+		TextureDecode::CI8ToIndex(src + y * width, row, width);
 		for (size_t x = 0; x < width; x++)
-		{
-			size_t pos = rawDataIndex + ((y * width) + x) * 1;
-			uint8_t grayscale = parentRawData.at(pos);
+			usedIndices[row[x]] = true;
+	}
 
-			textureData.SetIndexedPixel(y, x, grayscale, grayscale);
-		}
+	for (size_t i = 0; i < 256; i++)
+	{
+		if (usedIndices[i])
+			textureData.SetPaletteIndex(i, i, i, i, 255);
 	}
 }
 
@@ -740,6 +709,93 @@ TextureType ZTexture::GetTextureType() const
 	return format;
 }
 
+const ImageBackend& ZTexture::GetTextureData() const
+{
+	return textureData;
+}
+
+bool ZTexture::IsExportedAsRGBA8() const
+{
+	// TLUTs stay as they are, a CI texture that isn't pre-decoded may still load them
+	if (isPalette || format == TextureType::Error)
+		return false;
+
+	if (IsColorIndexed() && !HasTlut())
+		return false;
+
+	if (parent != nullptr && parent->rgba8Textures)
+		return true;
+
+	return Globals::Instance->rgba8TextureFormats.count(format) != 0;
+}
+
+std::vector<uint8_t> ZTexture::GetRGBA8Data() const
+{
+	size_t rowSize = static_cast<size_t>(width) * 4;
+	std::vector<uint8_t> rgba(rowSize * height);
+
+	for (size_t y = 0; y < height; y++)
+	{
+		const uint8_t* src = textureData.GetRowData(y);
+		uint8_t* dst = rgba.data() + y * rowSize;
+
+		switch (format)
+		{
+		case TextureType::Grayscale4bpp:
+		case TextureType::Grayscale8bpp:
+			for (size_t x = 0; x < width; x++)
+				memset(dst + x * 4, src[x * 3], 4);
+			break;
+
+		case TextureType::Palette4bpp:
+		case TextureType::Palette8bpp:
+			for (size_t x = 0; x < width; x++)
+			{
+				RGBAPixel color = textureData.GetPaletteColor(src[x]);
+				dst[x * 4 + 0] = color.r;
+				dst[x * 4 + 1] = color.g;
+				dst[x * 4 + 2] = color.b;
+				dst[x * 4 + 3] = color.a;
+			}
+			break;
+
+		default:
+			memcpy(dst, src, rowSize);
+			break;
+		}
+	}
+
+	rgba8ExportCount.fetch_add(1, std::memory_order_relaxed);
+	rgba8ExportRawBytes.fetch_add(GetRawDataSize(), std::memory_order_relaxed);
+	rgba8ExportBytes.fetch_add(rgba.size(), std::memory_order_relaxed);
+	return rgba;
+}
+
+bool ZTexture::IsExportedByOwner() const
+{
+	return exportedByOwner;
+}
+
+const std::string& ZTexture::GetOwnerResourcePath() const
+{
+	return ownerResourcePath;
+}
+
+void ZTexture::PrintRGBA8ExportReport()
+{
+	uint64_t count = rgba8ExportCount.load(std::memory_order_relaxed);
+	if (count == 0)
+		return;
+
+	uint64_t rawBytes = rgba8ExportRawBytes.load(std::memory_order_relaxed);
+	uint64_t bytes = rgba8ExportBytes.load(std::memory_order_relaxed);
+
+	printf("RGBA8 textures: %" PRIu64 " exported, %" PRIu64 " KB instead of %" PRIu64
+	       " KB (%.2fx)\n",
+	       count, bytes / 1024, rawBytes / 1024,
+	       rawBytes != 0 ? static_cast<double>(bytes) / rawBytes : 0.0);
+}
+
 void ZTexture::Save(const fs::path& outFolder)
 {
 	// Optionally generate text file containing CRC information. This is going to be a one time
@@ -750,6 +806,14 @@ void ZTexture::Save(const fs::path& outFolder)
 		                   StringHelper::Sprintf("%08lX", hash));
 	}
 
+	// The declaration includes the file of an identical texture instead, and the exporters
+	// reference its resource
+	if (exportedByOwner)
+	{
+		TextureCache::RecordExportHit(GetRawDataSize());
+		return;
+	}
+
 	// Do not save png files if we're making an OTR file. They're not needed...
 	if (Globals::Instance->otrMode)
 		return;
@@ -773,7 +837,10 @@ void ZTexture::Save(const fs::path& outFolder)
 		printf("\t TLUT name: %s\n", tlut->name.c_str());
 #endif
 
-	textureData.WritePng(outFileName);
+	if (PngEncodeQueue::IsRunning())
+		PngEncodeQueue::Push(textureData, outFileName, Globals::Instance->pngSettings);
+	else
+		textureData.WritePng(outFileName, Globals::Instance->pngSettings);
 
 #ifdef TEXTURE_DEBUG
 	printf("\n");
@@ -823,6 +890,30 @@ Declaration* ZTexture::DeclareVar(const std::string& prefix,
 				                               GetExternalExtension().c_str());
 		}
 	}
+
+	// TEXTURE DEDUP CHECK
+	// The TLUT is applied after decoding, so color-indexed textures may still differ
+	exportedByOwner = false;
+	ownerResourcePath.clear();
+	if (cacheEntry != nullptr && !IsColorIndexed())
+	{
+		if (cacheEntry->ownerFile == parent->GetName() && cacheEntry->ownerOffset == rawDataIndex)
+			TextureCache::SetOwnerDeclaration(cacheEntry, incStr, auxName);
+		else if (cacheEntry->ownerDWordAligned == dWordAligned)
+		{
+			// Empty if the owner hasn't been declared yet, i.e. it lives in a file that another
+			// worker is still parsing
+			std::string ownerIncStr = TextureCache::GetOwnerIncludePath(cacheEntry);
+			if (!ownerIncStr.empty())
+			{
+				incStr = ownerIncStr;
+				exportedByOwner = true;
+				ownerResourcePath = cacheEntry->ownerFile + "/" +
+				                    TextureCache::GetOwnerName(cacheEntry);
+			}
+		}
+	}
+
 	size_t texSizeDivisor = (dWordAligned) ? 8 : 4;
 
 	Declaration* decl;
@@ -850,24 +941,37 @@ std::string ZTexture::GetBodySourceCode() const
 	if (!Globals::Instance->otrMode)
 	{
 		size_t texSizeInc = (dWordAligned) ? 8 : 4;
-		for (size_t i = 0; i < textureDataRaw.size(); i += texSizeInc)
-		{
-			if (i % 32 == 0)
-				sourceOutput += "    ";
-			if (dWordAligned)
-				sourceOutput +=
-					StringHelper::Sprintf("0x%016llX, ", BitConverter::ToUInt64BE(textureDataRaw, i));
-			else
-				sourceOutput +=
-					StringHelper::Sprintf("0x%08llX, ", BitConverter::ToUInt32BE(textureDataRaw, i));
-			if (i % 32 == 24)
-				sourceOutput += StringHelper::Sprintf(" // 0x%06X \n", rawDataIndex + ((i / 32) * 32));
-		}
+		size_t elementCount = (textureDataRaw.size() + texSizeInc - 1) / texSizeInc;
+
+		// Indent, "0x%016llX, " and " // 0x%06X \n" are at most 4 + 20 + 16 bytes per element
+		SourceEmitter::Append(sourceOutput, elementCount * 40 + 1, [&](char* dst) {
+			for (size_t i = 0; i < textureDataRaw.size(); i += texSizeInc)
+			{
+				uint64_t value = 0;
+				for (size_t j = i; j < i + texSizeInc; j++)
+					value = (value << 8) | (j < textureDataRaw.size() ? textureDataRaw[j] : 0);
+
+				if (i % 32 == 0)
+					dst = SourceEmitter::Text(dst, "    ");
+				dst = SourceEmitter::Text(dst, "0x");
+				dst = SourceEmitter::Hex(dst, value, texSizeInc * 2);
+				dst = SourceEmitter::Text(dst, ", ");
+				if (i % 32 == 24)
+				{
+					uint32_t rowOffset = rawDataIndex + ((i / 32) * 32);
+
+					dst = SourceEmitter::Text(dst, " // 0x");
+					dst = SourceEmitter::Hex(dst, rowOffset, 6);
+					dst = SourceEmitter::Text(dst, " \n");
+				}
+			}
 
-		// Ensure there's always a trailing line feed to prevent dumb warnings.
-		// Please don't remove this line, unless you somehow made a way to prevent
-		// that warning when building the OoT repo.
-		sourceOutput += "\n";
+			// Ensure there's always a trailing line feed to prevent dumb warnings.
+			// Please don't remove this line, unless you somehow made a way to prevent
+			// that warning when building the OoT repo.
+			*dst++ = '\n';
+			return dst;
+		});
 	} else if (Globals::Instance->buildRawTexture) {
 		sourceOutput += std::string(textureDataRaw.begin(), textureDataRaw.end());
 	}
@@ -4,6 +4,8 @@
 #include "ZResource.h"
 #include "tinyxml2.h"
 
+struct TextureCacheEntry;
+
 enum class TextureType
 {
 	Error,
@@ -29,6 +31,12 @@ protected:
 	uint32_t tlutOffset = static_cast<uint32_t>(-1);
 	ZTexture* tlut = nullptr;
 	bool splitTlut;
+	TextureCacheEntry* cacheEntry = nullptr;
+	bool exportedByOwner = false;  // Declared as a reference to an identical texture's file
+	std::string ownerResourcePath;  // "<file>/<name>" of that texture
+
+	// Returns the texture's raw data, making sure `size` bytes of it are in bounds
+	const uint8_t* GetRawDataSpan(size_t size) const;
 
 	// The following functions convert from N64 binary data to a bitmap to be saved to a PNG.
 	void ConvertN64ToBitmap_RGBA16();
@@ -100,6 +108,35 @@ public:
 
 	TextureType GetTextureType() const;
 
+	/// <summary>
+	/// Returns the decoded image. Its rows can be handed to an encoder or an exporter as-is.
+	/// </summary>
+	const ImageBackend& GetTextureData() const;
+
+	/// <summary>
+	/// Returns if the exporters should write this texture pre-decoded to RGBA8, either because
+	/// of its format or because its file asks for it. Color-indexed textures also need a TLUT.
+	/// </summary>
+	bool IsExportedAsRGBA8() const;
+
+	/// <summary>
+	/// Returns the texture as RGBA8, 4 bytes per pixel with the TLUT already applied. This is
+	/// what the RDP would sample, so intensity textures use the intensity as alpha too.
+	/// </summary>
+	std::vector<uint8_t> GetRGBA8Data() const;
+
+	/// <summary>
+	/// Returns if an identical texture was exported first (`-tdedup`). The exporters then only
+	/// write a reference to it, GetOwnerResourcePath.
+	/// </summary>
+	bool IsExportedByOwner() const;
+	const std::string& GetOwnerResourcePath() const;
+
+	/// <summary>
+	/// Prints how many textures were exported as RGBA8 and how much bigger they got.
+	/// </summary>
+	static void PrintRGBA8ExportReport();
+
 	/// <summary>
 	/// Returns the path to the texture pool, taken from the config file.
 	/// </summary>
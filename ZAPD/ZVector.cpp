@@ -11,13 +11,17 @@
 
 REGISTER_ZFILENODE(Vector, ZVector);
 
+static const ResourceAttributeSchema vectorAttributes(&ZResource::commonAttributes, {
+	{"Type", true},
+	{"Dimensions", true},
+});
+
 ZVector::ZVector(ZFile* nParent) : ZResource(nParent)
 {
 	scalarType = ZScalarType::ZSCALAR_NONE;
 	dimensions = 0;
 
-	RegisterRequiredAttribute("Type");
-	RegisterRequiredAttribute("Dimensions");
+	attributeSchema = &vectorAttributes;
 }
 
 void ZVector::ExtractFromBinary(uint32_t nRawDataIndex, ZScalarType nScalarType,
@@ -38,9 +42,9 @@ void ZVector::ParseXML(tinyxml2::XMLElement* reader)
 {
 	ZResource::ParseXML(reader);
 
-	this->scalarType = ZScalar::MapOutputTypeToScalarType(registeredAttributes.at("Type").value);
+	this->scalarType = ZScalar::MapOutputTypeToScalarType(GetAttribute("Type").value);
 
-	this->dimensions = StringHelper::StrToL(registeredAttributes.at("Dimensions").value, 16);
+	this->dimensions = StringHelper::StrToL(GetAttribute("Dimensions").value, 16);
 }
 
 void ZVector::ParseRawData()
@@ -1,11 +1,34 @@
 #include "ZVtx.h"
 
+#include <type_traits>
+
+#include "BulkDecode.h"
+#include "SourceEmitter.h"
 #include "Utils/BitConverter.h"
 #include "Utils/StringHelper.h"
 #include "ZFile.h"
 
 REGISTER_ZFILENODE(Vtx, ZVtx);
 
+// "VTX(x, y, z, s, t, r, g, b, a)" is at most 5 + 9 * 6 + 8 * 2 + 1 bytes long
+static constexpr size_t maxVtxMacroLength = 76;
+
+// Writes "VTX(%i, %i, %i, %i, %i, %i, %i, %i, %i)"
+template <typename T>
+static char* WriteVtxMacro(char* dst, const T& vtx)
+{
+	const int64_t values[] = {vtx.x, vtx.y, vtx.z, vtx.s, vtx.t, vtx.r, vtx.g, vtx.b, vtx.a};
+
+	dst = SourceEmitter::Text(dst, "VTX(");
+	for (size_t i = 0; i < 9; i++)
+	{
+		if (i != 0)
+			dst = SourceEmitter::Text(dst, ", ");
+		dst = SourceEmitter::Dec(dst, values[i]);
+	}
+	return SourceEmitter::Text(dst, ")");
+}
+
 ZVtx::ZVtx(ZFile* nParent) : ZResource(nParent)
 {
 	x = 0;
@@ -46,8 +69,10 @@ Declaration* ZVtx::DeclareVar(const std::string& prefix, const std::string& body
 
 std::string ZVtx::GetBodySourceCode() const
 {
-	return StringHelper::Sprintf("VTX(%i, %i, %i, %i, %i, %i, %i, %i, %i)", x, y, z, s, t, r, g, b,
-	                             a);
+	std::string body;
+	SourceEmitter::Append(body, maxVtxMacroLength,
+	                      [this](char* dst) { return WriteVtxMacro(dst, *this); });
+	return body;
 }
 
 size_t ZVtx::GetRawDataSize() const
@@ -84,3 +109,42 @@ DeclarationAlignment ZVtx::GetDeclarationAlignment() const
 {
 	return DeclarationAlignment::Align8;
 }
+
+std::string VtxData::GetBodySourceCode() const
+{
+	std::string body;
+	SourceEmitter::Append(body, maxVtxMacroLength,
+	                      [this](char* dst) { return WriteVtxMacro(dst, *this); });
+	return body;
+}
+
+std::string VtxData::GetListBodySourceCode(const std::vector<VtxData>& vtxList)
+{
+	std::string body;
+	SourceEmitter::Append(body, vtxList.size() * (maxVtxMacroLength + 3), [&vtxList](char* dst) {
+		for (const auto& vtx : vtxList)
+		{
+			*dst++ = '\t';
+			dst = WriteVtxMacro(dst, vtx);
+			dst = SourceEmitter::Text(dst, ",\n");
+		}
+		return dst;
+	});
+	return body;
+}
+
+void VtxData::ParseList(const std::vector<uint8_t>& rawData, offset_t offset, size_t count,
+                        std::vector<VtxData>& vtxList)
+{
+	// VtxData mirrors the N64 Vtx layout, so the list can be decoded in place
+	static_assert(sizeof(VtxData) == 16 && std::is_trivially_copyable_v<VtxData>,
+	              "VtxData must match the layout of Vtx");
+
+	BulkDecode::CheckBounds(rawData, offset, count * 16, "VtxData::ParseList");
+
+	vtxList.resize(count);
+
+	// x, y, z, flag, s and t are 16-bit fields, r, g, b and a are bytes
+	BulkDecode::SwapU16Fields(rawData.data() + offset, reinterpret_cast<uint8_t*>(vtxList.data()),
+	                          count, 16, 0x3F);
+}
@@ -7,6 +7,28 @@
 #include "ZScalar.h"
 #include "tinyxml2.h"
 
+/**
+ * Plain vertex value, used by the bulk vertex lists (i.e. the ones referenced by display lists)
+ * which don't need a ZResource for each element
+ */
+class VtxData
+{
+public:
+	int16_t x, y, z;
+	uint16_t flag;
+	int16_t s, t;
+	uint8_t r, g, b, a;
+
+	std::string GetBodySourceCode() const;
+
+	// The body of a Vtx array holding `vtxList`, one "VTX(...)," line per vertex
+	static std::string GetListBodySourceCode(const std::vector<VtxData>& vtxList);
+
+	// Decodes `count` consecutive Vtx structs starting at `offset`
+	static void ParseList(const std::vector<uint8_t>& rawData, offset_t offset, size_t count,
+	                      std::vector<VtxData>& vtxList);
+};
+
 class ZVtx : public ZResource
 {
 public: